@@ -0,0 +1,471 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+// Headless throughput benchmark for the core.
+//
+// Runs a ROM, disk image or NSF for a fixed number of frames in a set of
+// configurations and prints one CSV line per configuration. Per-stage timings
+// and hot path counters are filled in when the core is built with NST_PROFILE.
+//
+// A previous run can be passed with --compare to fail on throughput
+// regressions beyond a tolerance.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <string>
+#include "../core/api/NstApiEmulator.hpp"
+#include "../core/api/NstApiMachine.hpp"
+#include "../core/api/NstApiVideo.hpp"
+#include "../core/api/NstApiSound.hpp"
+#include "../core/api/NstApiNsf.hpp"
+#include "../core/api/NstApiRewinder.hpp"
+#include "../core/api/NstApiProfiler.hpp"
+
+#ifdef _WIN32
+ #ifndef WIN32_LEAN_AND_MEAN
+ #define WIN32_LEAN_AND_MEAN
+ #endif
+ #include <windows.h>
+#else
+ #include <sys/time.h>
+#endif
+
+namespace
+{
+	using namespace Nes;
+
+	typedef Api::Video::RenderState::Filter Filter;
+
+	enum
+	{
+		EXIT_REGRESSION = 2
+	};
+
+	enum
+	{
+		VIDEO        = 0x01,
+		REWINDER     = 0x02,
+		BATCH        = 0x04,
+		BAND_LIMITED = 0x08,
+		CODE_CACHE   = 0x10,
+		PIPELINED    = 0x20
+	};
+
+	struct Config
+	{
+		const char* name;
+		Filter filter;
+		uint scale;
+		ulong sampleRate;
+		uint filterThreads;
+		uint flags;
+	};
+
+	const Config configs[] =
+	{
+		{ "none",                     Api::Video::RenderState::FILTER_NONE,    1, 0,      0, 0 },
+		{ "batch",                    Api::Video::RenderState::FILTER_NONE,    1, 0,      0, BATCH },
+		{ "code-cache",               Api::Video::RenderState::FILTER_NONE,    1, 0,      0, CODE_CACHE },
+		{ "video-none",               Api::Video::RenderState::FILTER_NONE,    1, 0,      0, VIDEO },
+		{ "video-ntsc",               Api::Video::RenderState::FILTER_NTSC,    1, 0,      0, VIDEO },
+		{ "video-ntsc-threads",       Api::Video::RenderState::FILTER_NTSC,    1, 0,      2, VIDEO },
+		{ "video-ntsc-pipeline",      Api::Video::RenderState::FILTER_NTSC,    1, 0,      0, VIDEO|PIPELINED },
+	#ifndef NST_NO_SCALEX
+		{ "video-scale2x",            Api::Video::RenderState::FILTER_SCALE2X, 2, 0,      0, VIDEO },
+		{ "video-scale3x",            Api::Video::RenderState::FILTER_SCALE3X, 3, 0,      0, VIDEO },
+	#endif
+	#ifndef NST_NO_HQ2X
+		{ "video-hq2x",               Api::Video::RenderState::FILTER_HQ2X,    2, 0,      0, VIDEO },
+		{ "video-hq3x",               Api::Video::RenderState::FILTER_HQ3X,    3, 0,      0, VIDEO },
+		{ "video-hq4x",               Api::Video::RenderState::FILTER_HQ4X,    4, 0,      0, VIDEO },
+		{ "video-hq4x-threads",       Api::Video::RenderState::FILTER_HQ4X,    4, 0,      2, VIDEO },
+		{ "video-hq4x-pipeline",      Api::Video::RenderState::FILTER_HQ4X,    4, 0,      2, VIDEO|PIPELINED },
+	#endif
+	#ifndef NST_NO_2XSAI
+		{ "video-2xsai",              Api::Video::RenderState::FILTER_2XSAI,   2, 0,      0, VIDEO },
+	#endif
+		{ "sound-11025",              Api::Video::RenderState::FILTER_NONE,    1, 11025,  0, 0 },
+		{ "sound-22050",              Api::Video::RenderState::FILTER_NONE,    1, 22050,  0, 0 },
+		{ "sound-44100",              Api::Video::RenderState::FILTER_NONE,    1, 44100,  0, 0 },
+		{ "sound-48000",              Api::Video::RenderState::FILTER_NONE,    1, 48000,  0, 0 },
+		{ "sound-96000",              Api::Video::RenderState::FILTER_NONE,    1, 96000,  0, 0 },
+		{ "sound-192000",             Api::Video::RenderState::FILTER_NONE,    1, 192000, 0, 0 },
+		{ "sound-bandlimited-44100",  Api::Video::RenderState::FILTER_NONE,    1, 44100,  0, BAND_LIMITED },
+		{ "sound-bandlimited-192000", Api::Video::RenderState::FILTER_NONE,    1, 192000, 0, BAND_LIMITED },
+		{ "rewinder",                 Api::Video::RenderState::FILTER_NONE,    1, 44100,  0, VIDEO|REWINDER },
+		{ "all",                      Api::Video::RenderState::FILTER_NTSC,    1, 48000,  2, VIDEO|PIPELINED|BAND_LIMITED|CODE_CACHE }
+	};
+
+	const uint NUM_CONFIGS = sizeof(configs) / sizeof(configs[0]);
+
+	const char* const stageNames[Api::Profiler::NUM_STAGES] =
+	{
+		"other_ns", "cpu_ns", "ppu_ns", "apu_ns", "hooks_ns", "cheats_ns", "video_ns"
+	};
+
+	const char* const counterNames[Api::Profiler::NUM_COUNTERS] =
+	{
+		"instructions", "ppu_syncs", "apu_samples", "hooks", "bank_swaps"
+	};
+
+	double Seconds()
+	{
+	#ifdef _WIN32
+		LARGE_INTEGER counter, frequency;
+		::QueryPerformanceCounter( &counter );
+		::QueryPerformanceFrequency( &frequency );
+		return double(counter.QuadPart) / double(frequency.QuadPart);
+	#else
+		timeval time;
+		::gettimeofday( &time, NULL );
+		return time.tv_sec + time.tv_usec * 0.000001;
+	#endif
+	}
+
+	struct Options
+	{
+		Options()
+		: frames(600), warmup(60), tolerance(5.0), compare(NULL), file(NULL) {}
+
+		ulong frames;
+		ulong warmup;
+		double tolerance;
+		const char* compare;
+		const char* file;
+		std::vector<uint> selected;
+	};
+
+	struct Run
+	{
+		double seconds;
+		double fps;
+		bool profiled;
+		Api::Profiler::Frame profile;
+	};
+
+	Result Execute(const Options& options,const Config& config,Run& run)
+	{
+		std::ifstream stream( options.file, std::ios::in|std::ios::binary );
+
+		if (!stream.is_open())
+			return RESULT_ERR_INVALID_FILE;
+
+		Api::Emulator emulator;
+		Result result;
+
+		if (NES_FAILED(result=Api::Machine(emulator).Load( stream, Api::Machine::FAVORED_NES_NTSC )))
+			return result;
+
+		Api::Video::RenderState renderState;
+
+		renderState.filter = config.filter;
+		renderState.width = (config.filter == Api::Video::RenderState::FILTER_NTSC ? Core::Video::Output::NTSC_WIDTH : Core::Video::Output::WIDTH * config.scale);
+		renderState.height = Core::Video::Output::HEIGHT * config.scale;
+		renderState.bits.count = 32;
+		renderState.bits.mask.r = 0x00FF0000;
+		renderState.bits.mask.g = 0x0000FF00;
+		renderState.bits.mask.b = 0x000000FF;
+
+		if (NES_FAILED(result=Api::Video(emulator).SetRenderState( renderState )))
+			return result;
+
+		if (config.sampleRate && NES_FAILED(result=Api::Sound(emulator).SetSampleRate( config.sampleRate )))
+			return result;
+
+		if (config.filterThreads && NES_FAILED(result=Api::Video(emulator).SetFilterThreads( config.filterThreads )))
+			return result;
+
+		if ((config.flags & PIPELINED) && NES_FAILED(result=Api::Video(emulator).EnablePipelining( true )))
+			return result;
+
+		if (config.flags & BAND_LIMITED)
+			Api::Sound(emulator).SetBandLimited( true );
+
+		if ((config.flags & CODE_CACHE) && NES_FAILED(result=emulator.EnableCodeCache( true )))
+			return result;
+
+		if ((config.flags & REWINDER) && NES_FAILED(result=Api::Rewinder(emulator).Enable( true )))
+			return result;
+
+		if (NES_FAILED(result=Api::Machine(emulator).Power( true )))
+			return result;
+
+		if (Api::Machine(emulator).Is( Api::Machine::SOUND ))
+			Api::Nsf(emulator).PlaySong();
+
+		std::vector<unsigned int> pixels( renderState.width * renderState.height );
+		std::vector<short> samples( config.sampleRate ? config.sampleRate / 50 : 1 );
+
+		Core::Video::Output video( &pixels.front(), renderState.width * sizeof(pixels.front()) );
+		Core::Sound::Output sound( &samples.front(), config.sampleRate / 60 );
+
+		Core::Video::Output* const videoOutput = ((config.flags & VIDEO) ? &video : NULL);
+		Core::Sound::Output* const soundOutput = (config.sampleRate ? &sound : NULL);
+
+		for (ulong i=0; i < options.warmup; ++i)
+		{
+			if (NES_FAILED(result=emulator.Execute( videoOutput, soundOutput, NULL )))
+				return result;
+		}
+
+		Api::Profiler(emulator).Reset();
+
+		const double start = Seconds();
+
+		if (config.flags & BATCH)
+		{
+			if (NES_FAILED(result=emulator.ExecuteFrames( options.frames )))
+				return result;
+		}
+		else for (ulong i=0; i < options.frames; ++i)
+		{
+			if (NES_FAILED(result=emulator.Execute( videoOutput, soundOutput, NULL )))
+				return result;
+		}
+
+		run.seconds = Seconds() - start;
+		run.fps = (run.seconds > 0 ? options.frames / run.seconds : 0);
+		run.profiled = NES_SUCCEEDED(Api::Profiler(emulator).GetAverage( run.profile ));
+
+		return RESULT_OK;
+	}
+
+	void PrintHeader()
+	{
+		std::printf( "config,frames,seconds,fps" );
+
+		for (uint i=0; i < Api::Profiler::NUM_STAGES; ++i)
+			std::printf( ",%s", stageNames[i] );
+
+		for (uint i=0; i < Api::Profiler::NUM_COUNTERS; ++i)
+			std::printf( ",%s", counterNames[i] );
+
+		std::printf( "\n" );
+	}
+
+	void PrintRun(const Config& config,const Options& options,const Run& run)
+	{
+		std::printf( "%s,%lu,%.6f,%.2f", config.name, options.frames, run.seconds, run.fps );
+
+		for (uint i=0; i < Api::Profiler::NUM_STAGES; ++i)
+		{
+			if (run.profiled)
+				std::printf( ",%lu", run.profile.nanoseconds[i] );
+			else
+				std::printf( "," );
+		}
+
+		for (uint i=0; i < Api::Profiler::NUM_COUNTERS; ++i)
+		{
+			if (run.profiled)
+				std::printf( ",%lu", run.profile.counters[i] );
+			else
+				std::printf( "," );
+		}
+
+		std::printf( "\n" );
+		std::fflush( stdout );
+	}
+
+	bool LoadBaseline(const char* path,std::vector<std::string>& names,std::vector<double>& fps)
+	{
+		std::ifstream stream( path );
+
+		if (!stream.is_open())
+			return false;
+
+		std::string line;
+
+		while (std::getline( stream, line ))
+		{
+			const std::string::size_type name = line.find( ',' );
+
+			if (name == std::string::npos || line.compare( 0, name, "config" ) == 0)
+				continue;
+
+			const std::string::size_type frames = line.find( ',', name + 1 );
+			const std::string::size_type seconds = (frames != std::string::npos ? line.find( ',', frames + 1 ) : frames);
+
+			if (seconds == std::string::npos)
+				continue;
+
+			names.push_back( line.substr( 0, name ) );
+			fps.push_back( std::atof( line.c_str() + seconds + 1 ) );
+		}
+
+		return true;
+	}
+
+	int Usage(const char* program)
+	{
+		std::fprintf
+		(
+			stderr,
+			"usage: %s [options] <file>\n"
+			"  --frames <n>       frames to time per configuration (default 600)\n"
+			"  --warmup <n>       untimed frames before each run (default 60)\n"
+			"  --config <name>    run only the given configuration, may be repeated\n"
+			"  --list             list the configurations and exit\n"
+			"  --compare <csv>    compare against the output of a previous run\n"
+			"  --tolerance <pct>  allowed fps drop in percent for --compare (default 5)\n",
+			program
+		);
+
+		return EXIT_FAILURE;
+	}
+
+	bool FindConfig(const char* name,uint& index)
+	{
+		for (index=0; index < NUM_CONFIGS; ++index)
+		{
+			if (std::strcmp( configs[index].name, name ) == 0)
+				return true;
+		}
+
+		return false;
+	}
+}
+
+int main(int argc,char** argv)
+{
+	Options options;
+
+	for (int i=1; i < argc; ++i)
+	{
+		const char* const arg = argv[i];
+		const char* const value = (i+1 < argc ? argv[i+1] : NULL);
+
+		if (std::strcmp( arg, "--list" ) == 0)
+		{
+			for (uint j=0; j < NUM_CONFIGS; ++j)
+				std::printf( "%s\n", configs[j].name );
+
+			return EXIT_SUCCESS;
+		}
+		else if (arg[0] == '-' && arg[1] == '-')
+		{
+			if (!value)
+				return Usage( argv[0] );
+
+			++i;
+
+			if (std::strcmp( arg, "--frames" ) == 0)
+			{
+				options.frames = std::strtoul( value, NULL, 10 );
+			}
+			else if (std::strcmp( arg, "--warmup" ) == 0)
+			{
+				options.warmup = std::strtoul( value, NULL, 10 );
+			}
+			else if (std::strcmp( arg, "--tolerance" ) == 0)
+			{
+				options.tolerance = std::atof( value );
+			}
+			else if (std::strcmp( arg, "--compare" ) == 0)
+			{
+				options.compare = value;
+			}
+			else if (std::strcmp( arg, "--config" ) == 0)
+			{
+				uint index;
+
+				if (!FindConfig( value, index ))
+				{
+					std::fprintf( stderr, "unknown configuration: %s\n", value );
+					return EXIT_FAILURE;
+				}
+
+				options.selected.push_back( index );
+			}
+			else
+			{
+				return Usage( argv[0] );
+			}
+		}
+		else if (!options.file)
+		{
+			options.file = arg;
+		}
+		else
+		{
+			return Usage( argv[0] );
+		}
+	}
+
+	if (!options.file || !options.frames)
+		return Usage( argv[0] );
+
+	if (options.selected.empty())
+	{
+		for (uint i=0; i < NUM_CONFIGS; ++i)
+			options.selected.push_back( i );
+	}
+
+	std::vector<std::string> baselineNames;
+	std::vector<double> baselineFps;
+
+	if (options.compare && !LoadBaseline( options.compare, baselineNames, baselineFps ))
+	{
+		std::fprintf( stderr, "can't open %s\n", options.compare );
+		return EXIT_FAILURE;
+	}
+
+	int status = EXIT_SUCCESS;
+
+	PrintHeader();
+
+	for (uint i=0; i < options.selected.size(); ++i)
+	{
+		const Config& config = configs[options.selected[i]];
+
+		Run run;
+
+		const Result result = Execute( options, config, run );
+
+		if (NES_FAILED(result))
+		{
+			std::fprintf( stderr, "%s: failed with error %d\n", config.name, int(result) );
+			status = EXIT_FAILURE;
+			continue;
+		}
+
+		PrintRun( config, options, run );
+
+		for (uint j=0; j < baselineNames.size(); ++j)
+		{
+			if (baselineNames[j] == config.name && run.fps < baselineFps[j] * (1.0 - options.tolerance / 100.0))
+			{
+				std::fprintf( stderr, "%s: regression, %.2f fps against %.2f fps\n", config.name, run.fps, baselineFps[j] );
+
+				if (status == EXIT_SUCCESS)
+					status = EXIT_REGRESSION;
+			}
+		}
+	}
+
+	return status;
+}
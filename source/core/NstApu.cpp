@@ -23,7 +23,10 @@
 ////////////////////////////////////////////////////////////////////////////////////////
 
 #include <cstring>
+#include <cmath>
 #include "NstCpu.hpp"
+#include "NstProfiler.hpp"
+#include "NstFpuPrecision.hpp"
 #include "NstState.hpp"
 #include "api/NstApiSound.hpp"
 #include "NstSoundRenderer.inl"
@@ -294,7 +297,7 @@ namespace Nes
 			if (!rate)
 				return RESULT_ERR_INVALID_PARAM;
 
-			if (rate < 11025 || rate > 96000)
+			if (rate < 11025 || rate > 192000)
 				return RESULT_ERR_UNSUPPORTED;
 
 			settings.rate = rate;
@@ -390,6 +393,15 @@ namespace Nes
 			}
 		}
 
+		void Apu::SetBandLimited(const bool enable)
+		{
+			if (settings.bandLimited != enable)
+			{
+				settings.bandLimited = enable;
+				UpdateSettings();
+			}
+		}
+
 		void Apu::EnableStereo(const bool enable)
 		{
 			if (settings.stereo != enable)
@@ -408,6 +420,7 @@ namespace Nes
 
 			Cycle rate; uint fixed;
 			CalculateOscillatorClock( rate, fixed );
+			synthesizer.Reset( rate );
 
 			square[0].UpdateSettings ( settings.muted ? 0 : settings.volumes[ Channel::APU_SQUARE1  ], rate, fixed );
 			square[1].UpdateSettings ( settings.muted ? 0 : settings.volumes[ Channel::APU_SQUARE2  ], rate, fixed );
@@ -636,8 +649,13 @@ namespace Nes
 				Cycle rateCounter = cycles.rateCounter;
 				const Cycle rate = cycles.rate;
 
+				if (extChannel)
+					extChannel->Prepare( (target - rateCounter + rate - 1) / rate );
+
 				do
 				{
+					NST_PROFILE_COUNT( APU_SAMPLES );
+
 					buffer << GetSample();
 
 					if (cycles.frameCounter <= rateCounter)
@@ -667,8 +685,12 @@ namespace Nes
 			{
 				Cycle rateCounter = cycles.rateCounter;
 
+				extChannel->Prepare( (target - rateCounter + cycles.rate - 1) / cycles.rate );
+
 				do
 				{
+					NST_PROFILE_COUNT( APU_SAMPLES );
+
 					buffer << GetSample();
 
 					if (extCounter <= rateCounter)
@@ -701,6 +723,60 @@ namespace Nes
 			}
 		}
 
+		void NST_FASTCALL Apu::SyncOnBand(const Cycle target)
+		{
+			NST_ASSERT( (stream && settings.audible && settings.bandLimited) && (cycles.rate && cycles.fixed) && (cycles.extCounter == Cpu::CYCLE_MAX) );
+
+			if (cycles.rateCounter < target)
+			{
+				Cycle rateCounter = cycles.rateCounter;
+				const Cycle rate = cycles.rate;
+
+				do
+				{
+					uint length = (target - rateCounter + rate - 1) / rate;
+
+					if (cycles.frameCounter <= rateCounter)
+						length = 1;
+					else if (length > (cycles.frameCounter - rateCounter + rate - 1) / rate + 1)
+						length = (cycles.frameCounter - rateCounter + rate - 1) / rate + 1;
+
+					if (length > Synthesizer::MAX_LENGTH)
+						length = Synthesizer::MAX_LENGTH;
+
+					Synthesize( length );
+					NST_PROFILE_COUNT_N( APU_SAMPLES, length );
+					rateCounter += (length - 1) * rate;
+
+					if (extChannel)
+						extChannel->Prepare( length );
+
+					do
+					{
+						buffer << Clamp<Channel::OUTPUT_MIN,Channel::OUTPUT_MAX>
+						(
+							dcBlocker.Apply( synthesizer.Read() ) + (extChannel ? extChannel->GetSample() : 0)
+						);
+					}
+					while (--length);
+
+					if (cycles.frameCounter <= rateCounter)
+						ClockFrameCounter();
+
+					rateCounter += rate;
+				}
+				while (rateCounter < target);
+
+				cycles.rateCounter = rateCounter;
+			}
+
+			if (cycles.frameCounter < target)
+			{
+				ClockFrameCounter();
+				NST_ASSERT( cycles.frameCounter >= target );
+			}
+		}
+
 		void NST_FASTCALL Apu::SyncOff(const Cycle target)
 		{
 			NST_ASSERT( !(stream && settings.audible) && cycles.fixed );
@@ -722,12 +798,13 @@ namespace Nes
 		void Apu::BeginFrame(Sound::Output* output)
 		{
 			stream = output;
-			updater = (output && settings.audible ? (cycles.extCounter == Cpu::CYCLE_MAX ? &Apu::SyncOn : &Apu::SyncOnExt) : &Apu::SyncOff);
+			updater = (output && settings.audible ? (cycles.extCounter == Cpu::CYCLE_MAX ? settings.bandLimited ? &Apu::SyncOnBand : &Apu::SyncOn : &Apu::SyncOnExt) : &Apu::SyncOff);
 		}
 
 		inline void Apu::Update(const Cycle target)
 		{
 			NST_ASSERT( cycles.fixed );
+			NST_PROFILE_SCOPE( STAGE_APU );
 			(*this.*updater)( target * cycles.fixed );
 		}
 
@@ -754,6 +831,9 @@ namespace Nes
 		{
 			NST_ASSERT( (stream && settings.audible) && (cycles.rate && cycles.fixed) );
 
+			if (updater == &Apu::SyncOnBand)
+				SyncOnBand( cpu.GetCycles() * cycles.fixed );
+
 			for (uint i=0; i < 2; ++i)
 			{
 				if (stream->length[i] && stream->samples[i])
@@ -765,6 +845,9 @@ namespace Nes
 
 					if (output << block)
 					{
+						if (extChannel)
+							extChannel->Prepare( stream->length[i] - block.length );
+
 						const Cycle target = cpu.GetCycles() * cycles.fixed;
 
 						if (cycles.rateCounter < target)
@@ -773,6 +856,8 @@ namespace Nes
 
 							do
 							{
+								NST_PROFILE_COUNT( APU_SAMPLES );
+
 								output << GetSample();
 
 								if (cycles.frameCounter <= rateCounter)
@@ -798,6 +883,8 @@ namespace Nes
 
 							do
 							{
+								NST_PROFILE_COUNT( APU_SAMPLES );
+
 								output << GetSample();
 							}
 							while (output);
@@ -810,6 +897,7 @@ namespace Nes
 		void Apu::EndFrame()
 		{
 			NST_ASSERT( (stream && settings.audible) == (updater != &Apu::SyncOff) );
+			NST_PROFILE_SCOPE( STAGE_APU );
 
 			if (updater != &Apu::SyncOff)
 			{
@@ -877,7 +965,7 @@ namespace Nes
 		#endif
 
 		Apu::Settings::Settings()
-		: rate(44100), bits(16), speed(0), muted(false), transpose(false), stereo(false), audible(true)
+		: rate(44100), bits(16), speed(0), muted(false), transpose(false), bandLimited(false), stereo(false), audible(true)
 		{
 			for (uint i=0; i < MAX_CHANNELS; ++i)
 				volumes[i] = Channel::DEFAULT_VOLUME;
@@ -998,6 +1086,148 @@ namespace Nes
 		#pragma optimize("s", on)
 		#endif
 
+		Apu::Synthesizer::Kernel::Kernel()
+		{
+			FpuPrecision precision;
+
+			const double pi = 3.1415926535897932;
+			const double cutoff = 0.9;
+
+			for (uint phase=0; phase < PHASES; ++phase)
+			{
+				double impulse[WIDTH];
+				double total = 0;
+
+				for (uint i=0; i < WIDTH; ++i)
+				{
+					const double x = i + 0.5 - WIDTH / 2 - double(phase) / PHASES;
+
+					impulse[i] = (x ? std::sin( pi * cutoff * x ) / (pi * x) : cutoff) *
+					(
+						0.42 + 0.5 * std::cos( pi * x / (WIDTH / 2) ) + 0.08 * std::cos( 2 * pi * x / (WIDTH / 2) )
+					);
+
+					total += impulse[i];
+				}
+
+				idword remainder = 1L << BITS;
+				uint peak = 0;
+
+				for (uint i=0; i < WIDTH; ++i)
+				{
+					taps[phase][i] = idword(std::floor( impulse[i] * (1L << BITS) / total + 0.5 ));
+					remainder -= taps[phase][i];
+
+					if (taps[phase][i] > taps[phase][peak])
+						peak = i;
+				}
+
+				taps[phase][peak] += remainder;
+			}
+		}
+
+		const Apu::Synthesizer::Kernel Apu::Synthesizer::kernel;
+
+		Apu::Synthesizer::Synthesizer()
+		: rate(1)
+		{
+			Clear();
+		}
+
+		void Apu::Synthesizer::Reset(const Cycle r)
+		{
+			NST_ASSERT( r );
+
+			rate = r;
+			Clear();
+		}
+
+		void Apu::Synthesizer::Clear()
+		{
+			pos = 0;
+			dac[0] = 0;
+			dac[1] = 0;
+			output[0] = 0;
+			output[1] = 0;
+			sum = 0;
+
+			std::memset( buffer, 0, sizeof(buffer) );
+		}
+
+		#ifdef NST_MSVC_OPTIMIZE
+		#pragma optimize("", on)
+		#endif
+
+		inline dword Apu::Mix(const dword squares,const dword others)
+		{
+			return
+			(
+				(squares ? NLN_SQ_0 / (NLN_SQ_1 / squares + NLN_SQ_2) : 0) +
+				(others ? NLN_TND_0 / (NLN_TND_1 / others + NLN_TND_2) : 0)
+			);
+		}
+
+		NST_SINGLE_CALL void Apu::Synthesizer::Begin()
+		{
+			if (pos)
+			{
+				for (uint i=0; i < WIDTH; ++i)
+				{
+					buffer[i] = buffer[pos+i];
+					buffer[pos+i] = 0;
+				}
+
+				pos = 0;
+			}
+		}
+
+		NST_SINGLE_CALL void Apu::Synthesizer::Update(const Cycle offset,const dword squares,const dword others)
+		{
+			NST_ASSERT( pos == 0 && offset < rate * MAX_LENGTH );
+
+			idword delta = 0;
+
+			if (dac[0] != squares)
+			{
+				dac[0] = squares;
+				const dword prev = output[0];
+				output[0] = Mix( squares, 0 );
+				delta += idword(output[0] - prev);
+			}
+
+			if (dac[1] != others)
+			{
+				dac[1] = others;
+				const dword prev = output[1];
+				output[1] = Mix( 0, others );
+				delta += idword(output[1] - prev);
+			}
+
+			if (delta)
+			{
+				const dword time = offset * PHASES / rate;
+				const idword* NST_RESTRICT taps = kernel.taps[time % PHASES];
+				idword* NST_RESTRICT dst = buffer + time / PHASES;
+
+				for (uint i=0; i < WIDTH; ++i)
+					dst[i] += delta * taps[i];
+			}
+		}
+
+		NST_SINGLE_CALL idword Apu::Synthesizer::Read()
+		{
+			NST_ASSERT( pos < MAX_LENGTH );
+
+			sum += buffer[pos];
+			buffer[pos++] = 0;
+
+			return signed_shr(sum,BITS);
+		}
+
+		#ifdef NST_MSVC_OPTIMIZE
+		#pragma optimize("s", on)
+		#endif
+
 		Apu::Channel::LengthCounter::LengthCounter()
 		{
 			Reset();
@@ -1212,6 +1442,10 @@ namespace Nes
 			return Cpu::CYCLE_MAX;
 		}
 
+		void Apu::Channel::Prepare(uint)
+		{
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("s", on)
 		#endif
@@ -1476,6 +1710,14 @@ namespace Nes
 			return lengthCounter.GetCount();
 		}
 
+		const byte Apu::Square::forms[4][8] =
+		{
+			{0x1F,0x00,0x1F,0x1F,0x1F,0x1F,0x1F,0x1F},
+			{0x1F,0x00,0x00,0x1F,0x1F,0x1F,0x1F,0x1F},
+			{0x1F,0x00,0x00,0x00,0x00,0x1F,0x1F,0x1F},
+			{0x00,0x1F,0x1F,0x00,0x00,0x00,0x00,0x00}
+		};
+
 		dword Apu::Square::GetSample()
 		{
 			NST_VERIFY( bool(active) == CanOutput() && timer >= 0 );
@@ -1485,14 +1727,6 @@ namespace Nes
 
 			if (active)
 			{
-				static const byte forms[4][8] =
-				{
-					{0x1F,0x00,0x1F,0x1F,0x1F,0x1F,0x1F,0x1F},
-					{0x1F,0x00,0x00,0x1F,0x1F,0x1F,0x1F,0x1F},
-					{0x1F,0x00,0x00,0x00,0x00,0x1F,0x1F,0x1F},
-					{0x00,0x1F,0x1F,0x00,0x00,0x00,0x00,0x00}
-				};
-
 				const byte* const NST_RESTRICT form = forms[duty];
 
 				if (timer >= 0)
@@ -1536,6 +1770,35 @@ namespace Nes
 			return amp;
 		}
 
+		NST_SINGLE_CALL dword Apu::Square::GetLevel() const
+		{
+			return active ? envelope.Volume() >> forms[duty][step] : 0;
+		}
+
+		NST_SINGLE_CALL dword Apu::Square::ClockEdge()
+		{
+			NST_ASSERT( active );
+
+			step = (step + 1) & 0x7;
+			timer += idword(frequency);
+
+			return envelope.Volume() >> forms[duty][step];
+		}
+
+		NST_SINGLE_CALL void Apu::Square::Advance(const Cycle length)
+		{
+			timer -= idword(length);
+
+			if (timer < 0)
+			{
+				NST_ASSERT( !active );
+
+				const uint count = (-timer + frequency - 1) / frequency;
+				step = (step + count) & 0x7;
+				timer += idword(count * frequency);
+			}
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("s", on)
 		#endif
@@ -1690,20 +1953,20 @@ namespace Nes
 				active = false;
 		}
 
+		const byte Apu::Triangle::pyramid[32] =
+		{
+			0x0,0x1,0x2,0x3,0x4,0x5,0x6,0x7,
+			0x8,0x9,0xA,0xB,0xC,0xD,0xE,0xF,
+			0xF,0xE,0xD,0xC,0xB,0xA,0x9,0x8,
+			0x7,0x6,0x5,0x4,0x3,0x2,0x1,0x0
+		};
+
 		NST_SINGLE_CALL dword Apu::Triangle::GetSample()
 		{
 			NST_VERIFY( bool(active) == CanOutput() && timer >= 0 );
 
 			if (active)
 			{
-				static const byte pyramid[32] =
-				{
-					0x0,0x1,0x2,0x3,0x4,0x5,0x6,0x7,
-					0x8,0x9,0xA,0xB,0xC,0xD,0xE,0xF,
-					0xF,0xE,0xD,0xC,0xB,0xA,0x9,0x8,
-					0x7,0x6,0x5,0x4,0x3,0x2,0x1,0x0
-				};
-
 				dword sum = timer;
 				timer -= idword(rate);
 
@@ -1739,6 +2002,27 @@ namespace Nes
 			return amp;
 		}
 
+		NST_SINGLE_CALL dword Apu::Triangle::GetLevel() const
+		{
+			return pyramid[step] * outputVolume * 3;
+		}
+
+		NST_SINGLE_CALL dword Apu::Triangle::ClockEdge()
+		{
+			NST_ASSERT( active );
+
+			step = (step + 1) & 0x1F;
+			timer += idword(frequency);
+
+			return GetLevel();
+		}
+
+		NST_SINGLE_CALL void Apu::Triangle::Advance(const Cycle length)
+		{
+			if (active)
+				timer -= idword(length);
+		}
+
 		inline uint Apu::Triangle::GetLengthCounter() const
 		{
 			return lengthCounter.GetCount();
@@ -1921,6 +2205,27 @@ namespace Nes
 			return 0;
 		}
 
+		NST_SINGLE_CALL dword Apu::Noise::GetLevel() const
+		{
+			return active && !(bits & 0x4000) ? envelope.Volume() * 2 : 0;
+		}
+
+		NST_SINGLE_CALL dword Apu::Noise::ClockEdge()
+		{
+			NST_ASSERT( active );
+
+			bits = (bits << 1) | ((bits >> 14 ^ bits >> shifter) & 0x1);
+			timer += idword(frequency);
+
+			return GetLevel();
+		}
+
+		NST_SINGLE_CALL void Apu::Noise::Advance(const Cycle length)
+		{
+			for (timer -= idword(length); timer < 0; timer += idword(frequency))
+				bits = (bits << 1) | ((bits >> 14 ^ bits >> shifter) & 0x1);
+		}
+
 		inline uint Apu::Noise::GetLengthCounter() const
 		{
 			return lengthCounter.GetCount();
@@ -2017,7 +2322,10 @@ namespace Nes
 				out.dac
 			};
 
-			state.Begin( chunk ).Begin( AsciiId<'R','E','G'>::V ).Write( data ).End().End();
+			state.Begin( chunk );
+			state.Begin( AsciiId<'R','E','G'>::V ).Write( data ).End();
+			state.Begin( AsciiId<'L','E','N'>::V ).Write16( dma.lengthCounter ).End();
+			state.End();
 		}
 
 		void Apu::Dmc::LoadState(State::Loader& state,const Cpu& cpu,const CpuModel model,Cycle& dmcClock)
@@ -2055,6 +2363,16 @@ namespace Nes
 						out.active = dma.buffered && outputVolume;
 						break;
 					}
+
+					case AsciiId<'L','E','N'>::V:
+					{
+						const uint length = state.Read16();
+
+						if (length <= 0xFF1 && (length != 0) == (dma.lengthCounter != 0))
+							dma.lengthCounter = length;
+
+						break;
+					}
 				}
 
 				state.End();
@@ -2249,6 +2567,7 @@ namespace Nes
 			noise.ClearAmp();
 			dmc.ClearAmp();
 
+			synthesizer.Clear();
 			dcBlocker.Reset();
 
 			buffer.Reset( settings.bits, false );
@@ -2340,17 +2659,70 @@ namespace Nes
 			cycles.frameIrqRepeat = repeat;
 		}
 
+		void Apu::Synthesize(const uint length)
+		{
+			NST_ASSERT( length && length <= Synthesizer::MAX_LENGTH );
+
+			const idword end = length * synthesizer.GetRate();
+
+			synthesizer.Begin();
+
+			dword levels[4] =
+			{
+				square[0].GetLevel(),
+				square[1].GetLevel(),
+				triangle.GetLevel(),
+				noise.GetLevel()
+			};
+
+			const dword dpcm = dmc.GetLevel();
+
+			synthesizer.Update( 0, levels[0] + levels[1], levels[2] + levels[3] + dpcm );
+
+			for (;;)
+			{
+				const idword edges[4] =
+				{
+					square[0].GetEdge( end ),
+					square[1].GetEdge( end ),
+					triangle.GetEdge( end ),
+					noise.GetEdge( end )
+				};
+
+				const idword edge = NST_MIN(NST_MIN(edges[0],edges[1]),NST_MIN(edges[2],edges[3]));
+
+				if (edge >= end)
+					break;
+
+				if (edges[0] == edge) levels[0] = square[0].ClockEdge();
+				if (edges[1] == edge) levels[1] = square[1].ClockEdge();
+				if (edges[2] == edge) levels[2] = triangle.ClockEdge();
+				if (edges[3] == edge) levels[3] = noise.ClockEdge();
+
+				synthesizer.Update( edge, levels[0] + levels[1], levels[2] + levels[3] + dpcm );
+			}
+
+			square[0].Advance( end );
+			square[1].Advance( end );
+			triangle.Advance( end );
+			noise.Advance( end );
+		}
+
 		NST_NO_INLINE Apu::Channel::Sample Apu::GetSample()
 		{
-			dword dac[2];
+			Channel::Sample sample;
+
+			if (settings.bandLimited)
+			{
+				Synthesize( 1 );
+				sample = synthesizer.Read();
+			}
+			else
+				sample = Mix( square[0].GetSample() + square[1].GetSample(), triangle.GetSample() + noise.GetSample() + dmc.GetSample() );
 
 			return Clamp<Channel::OUTPUT_MIN,Channel::OUTPUT_MAX>
 			(
-				dcBlocker.Apply
-				(
-					(0 != (dac[0] = square[0].GetSample() + square[1].GetSample()) ? NLN_SQ_0 / (NLN_SQ_1 / dac[0] + NLN_SQ_2) : 0) +
-					(0 != (dac[1] = triangle.GetSample() + noise.GetSample() + dmc.GetSample()) ? NLN_TND_0 / (NLN_TND_1 / dac[1] + NLN_TND_2) : 0)
-				) + (extChannel ? extChannel->GetSample() : 0)
+				dcBlocker.Apply( sample ) + (extChannel ? extChannel->GetSample() : 0)
 			);
 		}
 
@@ -67,6 +67,7 @@ namespace Nes
 			uint   GetVolume(uint) const;
 			void   Mute(bool);
 			void   SetAutoTranspose(bool);
+			void   SetBandLimited(bool);
 			void   EnableStereo(bool);
 
 			void SaveState(State::Saver&,dword) const;
@@ -122,6 +123,7 @@ namespace Nes
 				virtual void Reset() = 0;
 				virtual Sample GetSample() = 0;
 				virtual Cycle Clock(Cycle,Cycle,Cycle);
+				virtual void Prepare(uint);
 				virtual bool UpdateSettings() = 0;
 
 				class LengthCounter
@@ -294,9 +296,13 @@ namespace Nes
 			NES_DECL_PEEK( 40xx );
 
 			NST_NO_INLINE Channel::Sample GetSample();
+			void Synthesize(uint);
+
+			static inline dword Mix(dword,dword);
 
 			void NST_FASTCALL SyncOn    (Cycle);
 			void NST_FASTCALL SyncOnExt (Cycle);
+			void NST_FASTCALL SyncOnBand(Cycle);
 			void NST_FASTCALL SyncOff   (Cycle);
 
 			NST_NO_INLINE void ClockFrameIRQ(Cycle);
@@ -347,6 +353,55 @@ namespace Nes
 				NST_SINGLE_CALL dword Clock(dword,dword,const Cpu&);
 			};
 
+			class Synthesizer
+			{
+			public:
+
+				Synthesizer();
+
+				enum
+				{
+					MAX_LENGTH = 256
+				};
+
+				void Reset(Cycle);
+				void Clear();
+
+				NST_SINGLE_CALL void Begin();
+				NST_SINGLE_CALL void Update(Cycle,dword,dword);
+				NST_SINGLE_CALL idword Read();
+
+				Cycle GetRate() const
+				{
+					return rate;
+				}
+
+			private:
+
+				enum
+				{
+					PHASES = 32,
+					WIDTH  = 16,
+					BITS   = 13
+				};
+
+				struct Kernel
+				{
+					Kernel();
+
+					idword taps[PHASES][WIDTH];
+				};
+
+				uint pos;
+				Cycle rate;
+				dword dac[2];
+				dword output[2];
+				idword sum;
+				idword buffer[MAX_LENGTH+WIDTH];
+
+				static const Kernel kernel;
+			};
+
 			class Oscillator
 			{
 				enum
@@ -371,6 +426,11 @@ namespace Nes
 			public:
 
 				inline void ClearAmp();
+
+				idword GetEdge(idword limit) const
+				{
+					return active ? timer : limit;
+				}
 			};
 
 			class Square : public Oscillator
@@ -390,6 +450,10 @@ namespace Nes
 
 				dword GetSample();
 
+				NST_SINGLE_CALL dword GetLevel() const;
+				NST_SINGLE_CALL dword ClockEdge();
+				NST_SINGLE_CALL void Advance(Cycle);
+
 				NST_SINGLE_CALL void ClockEnvelope();
 				NST_SINGLE_CALL void ClockSweep(uint);
 
@@ -425,6 +489,8 @@ namespace Nes
 				uint sweepIncrease;
 				word sweepShift;
 				word waveLength;
+
+				static const byte forms[4][8];
 			};
 
 			class Triangle : public Oscillator
@@ -445,6 +511,10 @@ namespace Nes
 
 				NST_SINGLE_CALL dword GetSample();
 
+				NST_SINGLE_CALL dword GetLevel() const;
+				NST_SINGLE_CALL dword ClockEdge();
+				NST_SINGLE_CALL void Advance(Cycle);
+
 				NST_SINGLE_CALL void ClockLinearCounter();
 				NST_SINGLE_CALL void ClockLengthCounter();
 
@@ -477,6 +547,8 @@ namespace Nes
 				byte linearCtrl;
 				byte linearCounter;
 				Channel::LengthCounter lengthCounter;
+
+				static const byte pyramid[32];
 			};
 
 			class Noise : public Oscillator
@@ -495,6 +567,10 @@ namespace Nes
 
 				NST_SINGLE_CALL dword GetSample();
 
+				NST_SINGLE_CALL dword GetLevel() const;
+				NST_SINGLE_CALL dword ClockEdge();
+				NST_SINGLE_CALL void Advance(Cycle);
+
 				NST_SINGLE_CALL void ClockEnvelope();
 				NST_SINGLE_CALL void ClockLengthCounter();
 
@@ -538,6 +614,11 @@ namespace Nes
 
 				NST_SINGLE_CALL dword GetSample();
 
+				dword GetLevel() const
+				{
+					return curSample;
+				}
+
 				NST_SINGLE_CALL bool ClockDAC();
 				NST_SINGLE_CALL void Update();
 				NST_SINGLE_CALL void ClockDMA(Cpu&,Cycle&,uint=0);
@@ -599,6 +680,7 @@ namespace Nes
 				byte speed;
 				bool muted;
 				bool transpose;
+				bool bandLimited;
 				bool stereo;
 				bool audible;
 				byte volumes[MAX_CHANNELS];
@@ -609,6 +691,7 @@ namespace Nes
 			Cpu& cpu;
 			Cycles cycles;
 			Synchronizer synchronizer;
+			Synthesizer synthesizer;
 			Square square[2];
 			Triangle triangle;
 			Noise noise;
@@ -641,6 +724,11 @@ namespace Nes
 				return settings.transpose;
 			}
 
+			bool IsBandLimited() const
+			{
+				return settings.bandLimited;
+			}
+
 			bool InStereo() const
 			{
 				return settings.stereo;
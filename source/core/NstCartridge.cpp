@@ -185,6 +185,37 @@ namespace Nes
 			SetupBoard( prg, chr, NULL, NULL, profile, profileEx, NULL );
 		}
 
+		Result Cartridge::Identify(std::istream& stream,FavoredSystem favoredSystem,const ImageDatabase* database,Profile& profile)
+		{
+			Log::Suppressor logSupressor;
+			Ram prg, chr;
+			ProfileEx profileEx;
+
+			switch (Stream::In(&stream).Peek32())
+			{
+				case INES_ID:
+
+					Ines::Load( stream, NULL, false, NULL, prg, chr, favoredSystem, profile, profileEx, database );
+					break;
+
+				case UNIF_ID:
+
+					Unif::Load( stream, NULL, false, NULL, prg, chr, favoredSystem, profile, profileEx, database );
+					break;
+
+				default:
+
+					return RESULT_ERR_INVALID_FILE;
+			}
+
+			const Result result = SetupBoard( prg, chr, NULL, NULL, profile, profileEx, NULL );
+
+			if (NES_FAILED(result))
+				return result;
+
+			return profile.dump.state == Profile::Dump::BAD ? RESULT_WARN_BAD_DUMP : RESULT_OK;
+		}
+
 		uint Cartridge::GetDesiredController(uint port) const
 		{
 			NST_ASSERT( port < Api::Input::NUM_CONTROLLERS );
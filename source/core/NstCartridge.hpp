@@ -56,6 +56,7 @@ namespace Nes
 			static void ReadRomset(std::istream&,FavoredSystem,bool,Profile&);
 			static void ReadInes(std::istream&,FavoredSystem,Profile&);
 			static void ReadUnif(std::istream&,FavoredSystem,Profile&);
+			static Result Identify(std::istream&,FavoredSystem,const ImageDatabase*,Profile&);
 
 			class Ines;
 			class Unif;
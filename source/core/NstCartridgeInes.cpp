@@ -511,20 +511,32 @@ namespace Nes
 					const dword romLength = profile.board.GetPrg() + profile.board.GetChr();
 					dword count = 0;
 
+					byte buffer[MIN_DB_SEARCH_STRIDE];
+
 					for (Checksum it, checksum;;)
 					{
-						const uint data = stream.SafeRead8();
+						// read up to the next stride boundary without stepping over the ROM size
+
+						dword next = count - count % MIN_DB_SEARCH_STRIDE + MIN_DB_SEARCH_STRIDE;
+
+						if (count < romLength && romLength < next)
+							next = romLength;
+
+						if (next > MAX_DB_SEARCH_LENGTH)
+							next = MAX_DB_SEARCH_LENGTH;
+
+						const dword request = next - count;
+						const dword length = stream.SafeRead( buffer, request );
 
-						if (data <= 0xFF)
+						if (length)
 						{
-							const byte in = data;
-							it.Compute( &in, 1 );
+							it.Compute( buffer, length );
 
-							if (++count % MIN_DB_SEARCH_STRIDE == 0)
+							if ((count += length) % MIN_DB_SEARCH_STRIDE == 0)
 								checksum = it;
 						}
 
-						const bool stop = (data > 0xFF || count == MAX_DB_SEARCH_LENGTH);
+						const bool stop = (length < request || count == MAX_DB_SEARCH_LENGTH);
 
 						if (stop || count == romLength)
 						{
@@ -22,7 +22,6 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////
 
-#include <algorithm>
 #include "NstCpu.hpp"
 #include "NstCheats.hpp"
 
@@ -35,7 +34,7 @@ namespace Nes
 		#endif
 
 		Cheats::Cheats(Cpu& c)
-		: cpu(c), frameLocked(false) {}
+		: cpu(c), frameLocked(false), patchBase(0) {}
 
 		Cheats::~Cheats()
 		{
@@ -80,6 +79,11 @@ namespace Nes
 			{
 				const HiCode code = {address,data,compare,useCompare,NULL};
 
+				patches.Reserve
+				(
+					hiCodes.Size() ? NST_MAX(hiCodes.Back().address,address) - NST_MIN(hiCodes.Front().address,address) + 1U : 1U
+				);
+
 				HiCode* it = hiCodes.Begin();
 
 				for (const HiCode* const end=hiCodes.End(); ; ++it)
@@ -87,6 +91,7 @@ namespace Nes
 					if (it == end || it->address > address)
 					{
 						it = hiCodes.Insert( it, code );
+						Compile();
 						break;
 					}
 					else if (it->address == address)
@@ -124,6 +129,7 @@ namespace Nes
 				HiCode* const it = hiCodes.Begin() + index;
 				cpu.Unlink( it->address, this, &Cheats::Peek_Wizard, &Cheats::Poke_Wizard );
 				hiCodes.Erase( it );
+				Compile();
 				return RESULT_OK;
 			}
 			else
@@ -136,6 +142,7 @@ namespace Nes
 		{
 			loCodes.Defrag();
 			hiCodes.Defrag();
+			patches.Defrag();
 
 			for (HiCode *it=hiCodes.Begin(), *const end=hiCodes.End(); it != end; ++it)
 				Map( *it );
@@ -146,6 +153,23 @@ namespace Nes
 			code.port = cpu.Link( code.address, Cpu::LEVEL_HIGH, this, &Cheats::Peek_Wizard, &Cheats::Poke_Wizard );
 		}
 
+		void Cheats::Compile()
+		{
+			if (hiCodes.Size())
+			{
+				patchBase = hiCodes.Front().address;
+				patches.Resize( hiCodes.Back().address - patchBase + 1 );
+
+				for (dword i=0, n=hiCodes.Size(); i < n; ++i)
+					patches[hiCodes[i].address - patchBase] = i;
+			}
+			else
+			{
+				patchBase = 0;
+				patches.Clear();
+			}
+		}
+
 		void Cheats::ClearCodes()
 		{
 			loCodes.Destroy();
@@ -154,6 +178,8 @@ namespace Nes
 				cpu.Unlink( it->address, this, &Cheats::Peek_Wizard, &Cheats::Poke_Wizard );
 
 			hiCodes.Destroy();
+			patches.Destroy();
+			patchBase = 0;
 		}
 
 		Result Cheats::GetCode
@@ -225,26 +251,11 @@ namespace Nes
 			}
 		}
 
-		inline bool Cheats::HiCode::operator < (const Cheats::HiCode& c) const
-		{
-			return address < c.address;
-		}
-
-		inline bool Cheats::HiCode::operator < (Address a) const
-		{
-			return address < a;
-		}
-
-		inline bool operator < (Address a,const Cheats::HiCode& c)
-		{
-			return a < c.address;
-		}
-
 		NES_PEEK_A(Cheats,Wizard)
 		{
 			NST_ASSERT( address >= 0x2000 );
 
-			const HiCode* const NST_RESTRICT code = std::lower_bound( hiCodes.Begin(), hiCodes.End(), address );
+			const HiCode* const NST_RESTRICT code = hiCodes.Begin() + patches[address - patchBase];
 
 			if (!frameLocked)
 			{
@@ -268,7 +279,7 @@ namespace Nes
 		{
 			NST_ASSERT( address >= 0x2000 );
 
-			return std::lower_bound( hiCodes.Begin(), hiCodes.End(), address )->port->Poke( address, data );
+			return hiCodes[patches[address - patchBase]].port->Poke( address, data );
 		}
 	}
 }
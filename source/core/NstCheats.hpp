@@ -67,9 +67,6 @@ namespace Nes
 
 			struct HiCode
 			{
-				inline bool operator < (const HiCode&) const;
-				inline bool operator < (Address) const;
-
 				word address;
 				byte data;
 				byte compare;
@@ -77,17 +74,19 @@ namespace Nes
 				const Io::Port* port;
 			};
 
-			inline friend bool operator < (Address,const HiCode&);
-
 			typedef Vector<LoCode> LoCodes;
 			typedef Vector<HiCode> HiCodes;
+			typedef Vector<word> Patches;
 
 			void Map(HiCode&);
+			void Compile();
 
 			Cpu& cpu;
 			ibool frameLocked;
 			LoCodes loCodes;
 			HiCodes hiCodes;
+			Patches patches;
+			uint patchBase;
 
 		public:
 
@@ -79,11 +79,12 @@
 	#define NST_UNREACHABLE() __assume(0)
 	#endif
 
-	#if !defined(NST_MM_INTRINSICS) && defined(NST_WIN32) && defined(_M_IX86)
+	#if !defined(NST_MM_INTRINSICS) && defined(NST_WIN32) && (defined(_M_IX86) || defined(_M_X64))
 	#define NST_MM_INTRINSICS
 	#endif
 
 	#define NST_NO_VTABLE __declspec(novtable)
+	#define NST_THREAD_LOCAL __declspec(thread)
 
 	#if NST_MSVC >= 1400
 
@@ -128,6 +129,14 @@
    #define NST_REGCALL __attribute__((regparm(2)))
    #endif
 
+   #if NST_GCC >= 303
+   #define NST_THREAD_LOCAL __thread
+   #endif
+
+   #if !defined(NST_MM_INTRINSICS) && defined(__SSE2__)
+   #define NST_MM_INTRINSICS
+   #endif
+
   #endif
 
  #endif
@@ -142,6 +151,14 @@
  #define NST_RESTRICT restrict
  #endif
 
+ #ifndef NST_THREAD_LOCAL
+ #ifdef NST_WIN32
+ #define NST_THREAD_LOCAL __declspec(thread)
+ #else
+ #define NST_THREAD_LOCAL __thread
+ #endif
+ #endif
+
 #endif
 
 #define NST_NOP() ((void)0)
@@ -170,6 +187,10 @@
 #define NST_RESTRICT
 #endif
 
+#ifndef NST_THREAD_LOCAL
+#define NST_THREAD_LOCAL
+#endif
+
 #ifndef NST_UNREACHABLE
 #define NST_UNREACHABLE() NST_ASSERT(0)
 #endif
@@ -25,6 +25,7 @@
 #include <cstring>
 #include "NstCpu.hpp"
 #include "NstHook.hpp"
+#include "NstProfiler.hpp"
 #include "NstState.hpp"
 #include "api/NstApiUser.hpp"
 
@@ -32,8 +33,6 @@ namespace Nes
 {
 	namespace Core
 	{
-		dword Cpu::logged = 0;
-
 		void (Cpu::*const Cpu::opcodes[0x100])() =
 		{
 			&Cpu::op0x00, &Cpu::op0x01, &Cpu::op0x02, &Cpu::op0x03,
@@ -102,6 +101,302 @@ namespace Nes
 			&Cpu::op0xFC, &Cpu::op0xFD, &Cpu::op0xFE, &Cpu::op0xFF
 		};
 
+		void (Cpu::*const Cpu::decoders[0x100])() =
+		{
+			&Cpu::op0x00,
+			&Cpu::CodeIndX_R<&Cpu::Ora>,
+			&Cpu::op0x02,
+			&Cpu::op0x03,
+			&Cpu::op0x04,
+			&Cpu::CodeZpg_R<&Cpu::Ora>,
+			&Cpu::CodeZpg_RW<&Cpu::Asl>,
+			&Cpu::op0x07,
+			&Cpu::op0x08,
+			&Cpu::CodeImm_R<&Cpu::Ora>,
+			&Cpu::op0x0A,
+			&Cpu::op0x0B,
+			&Cpu::op0x0C,
+			&Cpu::CodeAbs_R<&Cpu::Ora>,
+			&Cpu::CodeAbs_RW<&Cpu::Asl>,
+			&Cpu::op0x0F,
+			&Cpu::CodeBpl,
+			&Cpu::CodeIndY_R<&Cpu::Ora>,
+			&Cpu::op0x12,
+			&Cpu::op0x13,
+			&Cpu::op0x14,
+			&Cpu::CodeZpgX_R<&Cpu::Ora>,
+			&Cpu::CodeZpgX_RW<&Cpu::Asl>,
+			&Cpu::op0x17,
+			&Cpu::op0x18,
+			&Cpu::CodeAbsY_R<&Cpu::Ora>,
+			&Cpu::op0x1A,
+			&Cpu::op0x1B,
+			&Cpu::op0x1C,
+			&Cpu::CodeAbsX_R<&Cpu::Ora>,
+			&Cpu::CodeAbsX_RW<&Cpu::Asl>,
+			&Cpu::op0x1F,
+			&Cpu::CodeJsr,
+			&Cpu::CodeIndX_R<&Cpu::And>,
+			&Cpu::op0x22,
+			&Cpu::op0x23,
+			&Cpu::CodeZpg_R<&Cpu::Bit>,
+			&Cpu::CodeZpg_R<&Cpu::And>,
+			&Cpu::CodeZpg_RW<&Cpu::Rol>,
+			&Cpu::op0x27,
+			&Cpu::op0x28,
+			&Cpu::CodeImm_R<&Cpu::And>,
+			&Cpu::op0x2A,
+			&Cpu::op0x2B,
+			&Cpu::CodeAbs_R<&Cpu::Bit>,
+			&Cpu::CodeAbs_R<&Cpu::And>,
+			&Cpu::CodeAbs_RW<&Cpu::Rol>,
+			&Cpu::op0x2F,
+			&Cpu::CodeBmi,
+			&Cpu::CodeIndY_R<&Cpu::And>,
+			&Cpu::op0x32,
+			&Cpu::op0x33,
+			&Cpu::op0x34,
+			&Cpu::CodeZpgX_R<&Cpu::And>,
+			&Cpu::CodeZpgX_RW<&Cpu::Rol>,
+			&Cpu::op0x37,
+			&Cpu::op0x38,
+			&Cpu::CodeAbsY_R<&Cpu::And>,
+			&Cpu::op0x3A,
+			&Cpu::op0x3B,
+			&Cpu::op0x3C,
+			&Cpu::CodeAbsX_R<&Cpu::And>,
+			&Cpu::CodeAbsX_RW<&Cpu::Rol>,
+			&Cpu::op0x3F,
+			&Cpu::op0x40,
+			&Cpu::CodeIndX_R<&Cpu::Eor>,
+			&Cpu::op0x42,
+			&Cpu::op0x43,
+			&Cpu::op0x44,
+			&Cpu::CodeZpg_R<&Cpu::Eor>,
+			&Cpu::CodeZpg_RW<&Cpu::Lsr>,
+			&Cpu::op0x47,
+			&Cpu::op0x48,
+			&Cpu::CodeImm_R<&Cpu::Eor>,
+			&Cpu::op0x4A,
+			&Cpu::op0x4B,
+			&Cpu::CodeJmpAbs,
+			&Cpu::CodeAbs_R<&Cpu::Eor>,
+			&Cpu::CodeAbs_RW<&Cpu::Lsr>,
+			&Cpu::op0x4F,
+			&Cpu::CodeBvc,
+			&Cpu::CodeIndY_R<&Cpu::Eor>,
+			&Cpu::op0x52,
+			&Cpu::op0x53,
+			&Cpu::op0x54,
+			&Cpu::CodeZpgX_R<&Cpu::Eor>,
+			&Cpu::CodeZpgX_RW<&Cpu::Lsr>,
+			&Cpu::op0x57,
+			&Cpu::op0x58,
+			&Cpu::CodeAbsY_R<&Cpu::Eor>,
+			&Cpu::op0x5A,
+			&Cpu::op0x5B,
+			&Cpu::op0x5C,
+			&Cpu::CodeAbsX_R<&Cpu::Eor>,
+			&Cpu::CodeAbsX_RW<&Cpu::Lsr>,
+			&Cpu::op0x5F,
+			&Cpu::op0x60,
+			&Cpu::CodeIndX_R<&Cpu::Adc>,
+			&Cpu::op0x62,
+			&Cpu::op0x63,
+			&Cpu::op0x64,
+			&Cpu::CodeZpg_R<&Cpu::Adc>,
+			&Cpu::CodeZpg_RW<&Cpu::Ror>,
+			&Cpu::op0x67,
+			&Cpu::op0x68,
+			&Cpu::CodeImm_R<&Cpu::Adc>,
+			&Cpu::op0x6A,
+			&Cpu::op0x6B,
+			&Cpu::op0x6C,
+			&Cpu::CodeAbs_R<&Cpu::Adc>,
+			&Cpu::CodeAbs_RW<&Cpu::Ror>,
+			&Cpu::op0x6F,
+			&Cpu::CodeBvs,
+			&Cpu::CodeIndY_R<&Cpu::Adc>,
+			&Cpu::op0x72,
+			&Cpu::op0x73,
+			&Cpu::op0x74,
+			&Cpu::CodeZpgX_R<&Cpu::Adc>,
+			&Cpu::CodeZpgX_RW<&Cpu::Ror>,
+			&Cpu::op0x77,
+			&Cpu::op0x78,
+			&Cpu::CodeAbsY_R<&Cpu::Adc>,
+			&Cpu::op0x7A,
+			&Cpu::op0x7B,
+			&Cpu::op0x7C,
+			&Cpu::CodeAbsX_R<&Cpu::Adc>,
+			&Cpu::CodeAbsX_RW<&Cpu::Ror>,
+			&Cpu::op0x7F,
+			&Cpu::op0x80,
+			&Cpu::CodeIndX_W<&Cpu::Sta>,
+			&Cpu::op0x82,
+			&Cpu::op0x83,
+			&Cpu::CodeZpg_W<&Cpu::Sty>,
+			&Cpu::CodeZpg_W<&Cpu::Sta>,
+			&Cpu::CodeZpg_W<&Cpu::Stx>,
+			&Cpu::op0x87,
+			&Cpu::op0x88,
+			&Cpu::op0x89,
+			&Cpu::op0x8A,
+			&Cpu::op0x8B,
+			&Cpu::CodeAbs_W<&Cpu::Sty>,
+			&Cpu::CodeAbs_W<&Cpu::Sta>,
+			&Cpu::CodeAbs_W<&Cpu::Stx>,
+			&Cpu::op0x8F,
+			&Cpu::CodeBcc,
+			&Cpu::CodeIndY_W<&Cpu::Sta>,
+			&Cpu::op0x92,
+			&Cpu::op0x93,
+			&Cpu::CodeZpgX_W<&Cpu::Sty>,
+			&Cpu::CodeZpgX_W<&Cpu::Sta>,
+			&Cpu::CodeZpgY_W<&Cpu::Stx>,
+			&Cpu::op0x97,
+			&Cpu::op0x98,
+			&Cpu::CodeAbsY_W<&Cpu::Sta>,
+			&Cpu::op0x9A,
+			&Cpu::op0x9B,
+			&Cpu::op0x9C,
+			&Cpu::CodeAbsX_W<&Cpu::Sta>,
+			&Cpu::op0x9E,
+			&Cpu::op0x9F,
+			&Cpu::CodeImm_R<&Cpu::Ldy>,
+			&Cpu::CodeIndX_R<&Cpu::Lda>,
+			&Cpu::CodeImm_R<&Cpu::Ldx>,
+			&Cpu::op0xA3,
+			&Cpu::CodeZpg_R<&Cpu::Ldy>,
+			&Cpu::CodeZpg_R<&Cpu::Lda>,
+			&Cpu::CodeZpg_R<&Cpu::Ldx>,
+			&Cpu::op0xA7,
+			&Cpu::op0xA8,
+			&Cpu::CodeImm_R<&Cpu::Lda>,
+			&Cpu::op0xAA,
+			&Cpu::op0xAB,
+			&Cpu::CodeAbs_R<&Cpu::Ldy>,
+			&Cpu::CodeAbs_R<&Cpu::Lda>,
+			&Cpu::CodeAbs_R<&Cpu::Ldx>,
+			&Cpu::op0xAF,
+			&Cpu::CodeBcs,
+			&Cpu::CodeIndY_R<&Cpu::Lda>,
+			&Cpu::op0xB2,
+			&Cpu::op0xB3,
+			&Cpu::CodeZpgX_R<&Cpu::Ldy>,
+			&Cpu::CodeZpgX_R<&Cpu::Lda>,
+			&Cpu::CodeZpgY_R<&Cpu::Ldx>,
+			&Cpu::op0xB7,
+			&Cpu::op0xB8,
+			&Cpu::CodeAbsY_R<&Cpu::Lda>,
+			&Cpu::op0xBA,
+			&Cpu::op0xBB,
+			&Cpu::CodeAbsX_R<&Cpu::Ldy>,
+			&Cpu::CodeAbsX_R<&Cpu::Lda>,
+			&Cpu::CodeAbsY_R<&Cpu::Ldx>,
+			&Cpu::op0xBF,
+			&Cpu::CodeImm_R<&Cpu::Cpy>,
+			&Cpu::CodeIndX_R<&Cpu::Cmp>,
+			&Cpu::op0xC2,
+			&Cpu::op0xC3,
+			&Cpu::CodeZpg_R<&Cpu::Cpy>,
+			&Cpu::CodeZpg_R<&Cpu::Cmp>,
+			&Cpu::CodeZpg_RW<&Cpu::Dec>,
+			&Cpu::op0xC7,
+			&Cpu::op0xC8,
+			&Cpu::CodeImm_R<&Cpu::Cmp>,
+			&Cpu::op0xCA,
+			&Cpu::op0xCB,
+			&Cpu::CodeAbs_R<&Cpu::Cpy>,
+			&Cpu::CodeAbs_R<&Cpu::Cmp>,
+			&Cpu::CodeAbs_RW<&Cpu::Dec>,
+			&Cpu::op0xCF,
+			&Cpu::CodeBne,
+			&Cpu::CodeIndY_R<&Cpu::Cmp>,
+			&Cpu::op0xD2,
+			&Cpu::op0xD3,
+			&Cpu::op0xD4,
+			&Cpu::CodeZpgX_R<&Cpu::Cmp>,
+			&Cpu::CodeZpgX_RW<&Cpu::Dec>,
+			&Cpu::op0xD7,
+			&Cpu::op0xD8,
+			&Cpu::CodeAbsY_R<&Cpu::Cmp>,
+			&Cpu::op0xDA,
+			&Cpu::op0xDB,
+			&Cpu::op0xDC,
+			&Cpu::CodeAbsX_R<&Cpu::Cmp>,
+			&Cpu::CodeAbsX_RW<&Cpu::Dec>,
+			&Cpu::op0xDF,
+			&Cpu::CodeImm_R<&Cpu::Cpx>,
+			&Cpu::CodeIndX_R<&Cpu::Sbc>,
+			&Cpu::op0xE2,
+			&Cpu::op0xE3,
+			&Cpu::CodeZpg_R<&Cpu::Cpx>,
+			&Cpu::CodeZpg_R<&Cpu::Sbc>,
+			&Cpu::CodeZpg_RW<&Cpu::Inc>,
+			&Cpu::op0xE7,
+			&Cpu::op0xE8,
+			&Cpu::CodeImm_R<&Cpu::Sbc>,
+			&Cpu::op0xEA,
+			&Cpu::CodeImm_R<&Cpu::Sbc>,
+			&Cpu::CodeAbs_R<&Cpu::Cpx>,
+			&Cpu::CodeAbs_R<&Cpu::Sbc>,
+			&Cpu::CodeAbs_RW<&Cpu::Inc>,
+			&Cpu::op0xEF,
+			&Cpu::CodeBeq,
+			&Cpu::CodeIndY_R<&Cpu::Sbc>,
+			&Cpu::op0xF2,
+			&Cpu::op0xF3,
+			&Cpu::op0xF4,
+			&Cpu::CodeZpgX_R<&Cpu::Sbc>,
+			&Cpu::CodeZpgX_RW<&Cpu::Inc>,
+			&Cpu::op0xF7,
+			&Cpu::op0xF8,
+			&Cpu::CodeAbsY_R<&Cpu::Sbc>,
+			&Cpu::op0xFA,
+			&Cpu::op0xFB,
+			&Cpu::op0xFC,
+			&Cpu::CodeAbsX_R<&Cpu::Sbc>,
+			&Cpu::CodeAbsX_RW<&Cpu::Inc>,
+			&Cpu::op0xFF
+		};
+
+		const byte Cpu::Code::lengths[0x100] =
+		{
+			1, 2, 1, 1, 1, 2, 2, 1,
+			1, 2, 1, 1, 1, 3, 3, 1,
+			2, 2, 1, 1, 1, 2, 2, 1,
+			1, 3, 1, 1, 1, 3, 3, 1,
+			3, 2, 1, 1, 2, 2, 2, 1,
+			1, 2, 1, 1, 3, 3, 3, 1,
+			2, 2, 1, 1, 1, 2, 2, 1,
+			1, 3, 1, 1, 1, 3, 3, 1,
+			1, 2, 1, 1, 1, 2, 2, 1,
+			1, 2, 1, 1, 3, 3, 3, 1,
+			2, 2, 1, 1, 1, 2, 2, 1,
+			1, 3, 1, 1, 1, 3, 3, 1,
+			1, 2, 1, 1, 1, 2, 2, 1,
+			1, 2, 1, 1, 1, 3, 3, 1,
+			2, 2, 1, 1, 1, 2, 2, 1,
+			1, 3, 1, 1, 1, 3, 3, 1,
+			1, 2, 1, 1, 2, 2, 2, 1,
+			1, 1, 1, 1, 3, 3, 3, 1,
+			2, 2, 1, 1, 2, 2, 2, 1,
+			1, 3, 1, 1, 1, 3, 1, 1,
+			2, 2, 2, 1, 2, 2, 2, 1,
+			1, 2, 1, 1, 3, 3, 3, 1,
+			2, 2, 1, 1, 2, 2, 2, 1,
+			1, 3, 1, 1, 3, 3, 3, 1,
+			2, 2, 1, 1, 2, 2, 2, 1,
+			1, 2, 1, 1, 3, 3, 3, 1,
+			2, 2, 1, 1, 1, 2, 2, 1,
+			1, 3, 1, 1, 1, 3, 3, 1,
+			2, 2, 1, 1, 2, 2, 2, 1,
+			1, 2, 1, 2, 3, 3, 3, 1,
+			2, 2, 1, 1, 1, 2, 2, 1,
+			1, 3, 1, 1, 1, 3, 3, 1
+		};
+
 		const byte Cpu::writeClocks[0x100] =
 		{
 			0x1C, 0x00, 0x00, 0xC0, 0x00, 0x00, 0x18, 0x18,
@@ -153,6 +448,7 @@ namespace Nes
 		apu   ( *this ),
 		map   ( this, &Cpu::Peek_Overflow, &Cpu::Poke_Overflow )
 		{
+			ram.bank = ram.mem;
 			cycles.UpdateTable( GetModel() );
 			Reset( false, false );
 		}
@@ -193,6 +489,7 @@ namespace Nes
 			}
 
 			opcode  = 0;
+			operand = 0;
 			flags.i = Flags::I;
 			jammed  = false;
 			ticks   = 0;
@@ -207,7 +504,11 @@ namespace Nes
 
 			interrupt.Reset();
 			hooks.Clear();
+			events.Clear();
 			linker.Clear();
+			map.ClearMemory();
+			code.Map( NULL, 0 );
+			idle.Reset();
 
 			if (on)
 			{
@@ -219,6 +520,11 @@ namespace Nes
 				map( 0xFFFC         ).Set( this, &Cpu::Peek_Jam_1,      &Cpu::Poke_Nop        );
 				map( 0xFFFD         ).Set( this, &Cpu::Peek_Jam_2,      &Cpu::Poke_Nop        );
 
+				MapMemory( 0x0000, 0x07FF, &ram.bank, RAM_SIZE-1, &ram, &Cpu::Ram::Peek_Ram_0, &Cpu::Ram::Poke_Ram_0 );
+				MapMemory( 0x0800, 0x0FFF, &ram.bank, RAM_SIZE-1, &ram, &Cpu::Ram::Peek_Ram_1, &Cpu::Ram::Poke_Ram_1 );
+				MapMemory( 0x1000, 0x17FF, &ram.bank, RAM_SIZE-1, &ram, &Cpu::Ram::Peek_Ram_2, &Cpu::Ram::Poke_Ram_2 );
+				MapMemory( 0x1800, 0x1FFF, &ram.bank, RAM_SIZE-1, &ram, &Cpu::Ram::Peek_Ram_3, &Cpu::Ram::Poke_Ram_3 );
+
 				apu.Reset( hard );
 			}
 			else
@@ -234,6 +540,7 @@ namespace Nes
 		{
 			NST_VERIFY( pc == RESET_VECTOR );
 
+			map.Validate();
 			pc = map.Peek16( RESET_VECTOR );
 
 			if (hard)
@@ -261,6 +568,29 @@ namespace Nes
 			hooks.Remove( hook );
 		}
 
+		void Cpu::AddEvent(const Hook& hook)
+		{
+			events.Add( hook );
+		}
+
+		void Cpu::MapCode(const byte* const mem,const dword size)
+		{
+			code.Map( mem, size );
+		}
+
+		void Cpu::EnableCodeCache(const bool enable)
+		{
+			code.Enable( enable );
+		}
+
+		void Cpu::SetIdleRange(const Address first,const Address last)
+		{
+			NST_ASSERT( first <= last && last < SIZE_64K );
+
+			idle.first = first;
+			idle.last = last;
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("", on)
 		#endif
@@ -541,10 +871,117 @@ namespace Nes
 			}
 		}
 
+		struct Cpu::Events::Event
+		{
+			Hook hook;
+			Cycle clock;
+		};
+
+		Cpu::Events::Events()
+		: events(new Event [1]), size(0), capacity(1), next(CYCLE_MAX) {}
+
+		Cpu::Events::~Events()
+		{
+			delete [] events;
+		}
+
+		void Cpu::Events::Clear()
+		{
+			size = 0;
+			next = CYCLE_MAX;
+		}
+
+		void Cpu::Events::Add(const Hook& hook)
+		{
+			for (uint i=0, n=size; i < n; ++i)
+			{
+				if (events[i].hook == hook)
+					return;
+			}
+
+			if (size == capacity)
+			{
+				Event* const NST_RESTRICT list = new Event [capacity+1];
+				++capacity;
+
+				for (uint i=0, n=size; i < n; ++i)
+					list[i] = events[i];
+
+				delete [] events;
+				events = list;
+			}
+
+			events[size].hook = hook;
+			events[size].clock = 0;
+			size++;
+
+			next = 0;
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("", on)
 		#endif
 
+		void Cpu::Events::Schedule(const Hook& hook,const Cycle clock)
+		{
+			for (uint i=0, n=size; i < n; ++i)
+			{
+				if (events[i].hook == hook)
+				{
+					events[i].clock = clock;
+
+					if (next > clock)
+						next = clock;
+
+					return;
+				}
+			}
+		}
+
+		void Cpu::Events::Execute(const Cycle count)
+		{
+			NST_PROFILE_SCOPE( STAGE_HOOKS );
+
+			for (uint i=0, n=size; i < n; ++i)
+			{
+				if (events[i].clock <= count)
+				{
+					events[i].clock = CYCLE_MAX;
+					events[i].hook.Execute();
+
+					NST_PROFILE_COUNT( HOOKS );
+				}
+			}
+
+			next = CYCLE_MAX;
+
+			for (uint i=0, n=size; i < n; ++i)
+			{
+				if (next > events[i].clock)
+					next = events[i].clock;
+			}
+		}
+
+		void Cpu::Events::Flush()
+		{
+			NST_PROFILE_SCOPE( STAGE_HOOKS );
+			NST_PROFILE_COUNT_N( HOOKS, size );
+
+			for (uint i=0, n=size; i < n; ++i)
+			{
+				events[i].hook.Execute();
+				events[i].clock = 0;
+			}
+
+			next = (size ? 0 : CYCLE_MAX);
+		}
+
+		void Cpu::ScheduleEvent(const Hook& hook,const Cycle clock)
+		{
+			events.Schedule( hook, clock );
+			cycles.NextRound( clock );
+		}
+
 		inline uint Cpu::Hooks::Size() const
 		{
 			return size;
@@ -732,9 +1169,161 @@ namespace Nes
 			low = 0;
 		}
 
+		void Cpu::Idle::Reset()
+		{
+			first = 1;
+			last = 0;
+
+			BeginFrame( false );
+		}
+
+		void Cpu::Idle::BeginFrame(const bool enable)
+		{
+			enabled = enable;
+
+			for (uint i=0; i < NUM_REJECTS; ++i)
+				rejects[i] = 0;
+		}
+
+		Cpu::Code::Code()
+		: rom(NULL), size(0), ops(NULL), enabled(false) {}
+
+		Cpu::Code::~Code()
+		{
+			delete [] ops;
+		}
+
+		void Cpu::Code::Map(const byte* const mem,const dword length)
+		{
+			delete [] ops;
+			ops = NULL;
+
+			rom = mem;
+			size = (mem ? length : 0);
+
+			if (enabled)
+				Decode();
+		}
+
+		void Cpu::Code::Enable(const bool enable)
+		{
+			delete [] ops;
+			ops = NULL;
+
+			enabled = enable;
+
+			if (enabled)
+				Decode();
+		}
+
+		void Cpu::Code::Decode()
+		{
+			NST_ASSERT( !ops );
+
+			if (!size)
+				return;
+
+			ops = new Op [size];
+
+			for (dword i=0; i < size; ++i)
+			{
+				Op& op = ops[i];
+
+				op.code = rom[i];
+				op.length = lengths[op.code];
+				op.operand = 0;
+
+				// instructions straddling a bank may see different
+				// operand bytes depending on the mapping, leave them
+				// to the regular fetch
+
+				if (op.length > 1)
+				{
+					if ((i & (BANK_SIZE-1)) + op.length > BANK_SIZE || i + op.length > size)
+						op.length = 0;
+					else
+						op.operand = rom[i+1] | (op.length == 3 ? uint(rom[i+2]) << 8 : 0U);
+				}
+			}
+		}
+
 		template<typename T,typename U>
 		Cpu::IoMap::IoMap(Cpu* cpu,T peek,U poke)
-		: Io::Map<SIZE_64K>( cpu, peek, poke ) {}
+		: Io::Map<SIZE_64K>( cpu, peek, poke )
+		{
+			ClearMemory();
+		}
+
+		void Cpu::IoMap::ClearMemory()
+		{
+			for (uint i=0; i < NUM_PAGES+1; ++i)
+			{
+				pages[i].mem = NULL;
+				pages[i].mask = 0;
+			}
+
+			for (uint i=0; i < NUM_PAGES; ++i)
+			{
+				sources[i].mem = NULL;
+				sources[i].mask = 0;
+			}
+
+			dirty = false;
+		}
+
+		void Cpu::IoMap::SetMemory(const Address first,const Address last,const byte* const* const mem,const uint mask,const Io::Port& port)
+		{
+			NST_ASSERT( first <= last && last < SIZE && !(first & (PAGE_SIZE-1)) && !(~last & (PAGE_SIZE-1)) && mem );
+
+			for (uint i=first >> PAGE_SHIFT, n=last >> PAGE_SHIFT; i <= n; ++i)
+			{
+				sources[i].mem = mem;
+				sources[i].mask = mask;
+				sources[i].port = port;
+				pages[i].mem = NULL;
+			}
+
+			dirty = true;
+		}
+
+		void Cpu::IoMap::Invalidate(const Address first,const Address last)
+		{
+			NST_ASSERT( first <= last && last < FULL_SIZE );
+
+			for (uint i=first >> PAGE_SHIFT, n=last >> PAGE_SHIFT; i <= n && i < NUM_PAGES; ++i)
+			{
+				if (sources[i].mem)
+				{
+					pages[i].mem = NULL;
+					dirty = true;
+				}
+			}
+		}
+
+		void Cpu::IoMap::Validate()
+		{
+			if (!dirty)
+				return;
+
+			dirty = false;
+
+			for (uint i=0; i < NUM_PAGES; ++i)
+			{
+				if (sources[i].mem && !pages[i].mem)
+				{
+					const Io::Port* NST_RESTRICT port = ports + (i << PAGE_SHIFT);
+					const Io::Port* const end = port + PAGE_SIZE;
+
+					while (port->SameReader( sources[i].port ) && ++port != end);
+
+					if (port == end)
+					{
+						pages[i].mem = sources[i].mem;
+						pages[i].mask = sources[i].mask;
+					}
+				}
+			}
+		}
 
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("", on)
@@ -743,13 +1332,19 @@ namespace Nes
 		inline uint Cpu::IoMap::Peek8(const uint address) const
 		{
 			NST_ASSERT( address < FULL_SIZE );
-			return ports[address].Peek( address );
+
+			const Page& page = pages[address >> PAGE_SHIFT];
+
+			if (page.mem)
+				return (*page.mem)[address & page.mask];
+			else
+				return ports[address].Peek( address );
 		}
 
 		inline uint Cpu::IoMap::Peek16(const uint address) const
 		{
 			NST_ASSERT( address < FULL_SIZE-1 );
-			return ports[address].Peek( address ) | ports[address + 1].Peek( address + 1 ) << 8;
+			return Peek8( address ) | Peek8( address + 1 ) << 8;
 		}
 
 		inline void Cpu::IoMap::Poke8(const uint address,const uint data) const
@@ -758,6 +1353,14 @@ namespace Nes
 			ports[address].Poke( address, data );
 		}
 
+		inline const byte* Cpu::IoMap::Direct(const uint address) const
+		{
+			NST_ASSERT( address < FULL_SIZE );
+
+			const Page& page = pages[address >> PAGE_SHIFT];
+			return page.mem ? *page.mem + (address & page.mask) : NULL;
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("s", on)
 		#endif
@@ -1123,8 +1726,13 @@ namespace Nes
 		{
 			if ((!!tmp) == STATE)
 			{
-				pc = ((tmp=pc+1) + sign_extend_8(uint(map.Peek8( pc )))) & 0xFFFF;
+				const uint data = map.Peek8( pc );
+
+				pc = ((tmp=pc+1) + sign_extend_8(data)) & 0xFFFF;
 				cycles.count += cycles.clock[2 + ((tmp^pc) >> 8 & 1)];
+
+				if ((data & 0x80) && idle.enabled)
+					SkipIdle( tmp - 2 );
 			}
 			else
 			{
@@ -1248,8 +1856,13 @@ namespace Nes
 
 		NST_SINGLE_CALL void Cpu::JmpAbs()
 		{
+			const uint address = pc - 1;
+
 			pc = map.Peek16( pc );
 			cycles.count += cycles.clock[JMP_ABS_CYCLES-1];
+
+			if (pc <= address && idle.enabled)
+				SkipIdle( address );
 		}
 
 		NST_SINGLE_CALL void Cpu::JmpInd()
@@ -1861,6 +2474,129 @@ namespace Nes
 			}
 		}
 
+		////////////////////////////////////////////////////////////////////////////////////////
+		// idle loops
+		////////////////////////////////////////////////////////////////////////////////////////
+
+		bool Cpu::IsIdleRead(const uint address) const
+		{
+			return map.Direct( address ) || (address >= idle.first && address <= idle.last);
+		}
+
+		bool Cpu::IsIdleOp(const uint address) const
+		{
+			if (!IsIdleRead( address ))
+				return false;
+
+			switch (map.Peek8( address ))
+			{
+				case 0x0A: case 0x18: case 0x2A: case 0x38:
+				case 0x4A: case 0x6A: case 0x88: case 0x8A:
+				case 0x98: case 0x9A: case 0xA8: case 0xAA:
+				case 0xB8: case 0xBA: case 0xC8: case 0xCA:
+				case 0xD8: case 0xE8: case 0xEA: case 0xF8:
+
+					// implied
+
+					return true;
+
+				case 0x09: case 0x10: case 0x29: case 0x30:
+				case 0x49: case 0x50: case 0x69: case 0x70:
+				case 0x90: case 0xA0: case 0xA2: case 0xA9:
+				case 0xB0: case 0xC0: case 0xC9: case 0xD0:
+				case 0xE0: case 0xE9: case 0xF0:
+
+					// immediate and relative
+
+					return IsIdleRead( (address + 1) & 0xFFFF );
+
+				case 0x05: case 0x24: case 0x25: case 0x45:
+				case 0x65: case 0xA4: case 0xA5: case 0xA6:
+				case 0xC4: case 0xC5: case 0xE4: case 0xE5:
+
+					// zero page reads
+
+					return IsIdleRead( (address + 1) & 0xFFFF ) && IsIdleRead( map.Peek8( (address + 1) & 0xFFFF ) );
+
+				case 0x0D: case 0x2C: case 0x2D: case 0x4D:
+				case 0x6D: case 0xAC: case 0xAD: case 0xAE:
+				case 0xCC: case 0xCD: case 0xEC: case 0xED:
+
+					// absolute reads
+
+					if (address <= 0xFFFD && IsIdleRead( address + 1 ) && IsIdleRead( address + 2 ))
+						return IsIdleRead( map.Peek16( address + 1 ) );
+
+					return false;
+
+				case 0x4C:
+
+					// jmp absolute
+
+					return address <= 0xFFFD && IsIdleRead( address + 1 ) && IsIdleRead( address + 2 );
+			}
+
+			return false;
+		}
+
+		NST_NO_INLINE void Cpu::SkipIdle(const uint branch)
+		{
+			// Called when the instruction at 'branch' jumped backwards. One more
+			// iteration is stepped through here, allowing only register operations
+			// and reads without side effects. If it comes back to the same place
+			// with an unchanged state, every following iteration is identical up
+			// to the next scheduled event, so all iterations which complete before
+			// cycles.round can be skipped. The rest runs as usual so that Clock()
+			// is reached on the exact same cycle.
+
+			const uint target = pc;
+			const dword loop = branch | dword(target) << 16;
+			dword* const reject = idle.rejects + ((branch ^ target) & (Idle::NUM_REJECTS-1));
+
+			if (*reject == loop)
+				return;
+
+			const uint state[] = { a, x, y, sp, flags.Pack() };
+			const Cycle start = cycles.count;
+
+			idle.enabled = false;
+
+			for (uint ops=0; cycles.count < cycles.round; ++ops)
+			{
+				const uint address = pc;
+
+				if (ops == Idle::MAX_OPS || !IsIdleOp( address ))
+				{
+					*reject = loop;
+					break;
+				}
+
+				ExecuteOp();
+
+				if (address == branch)
+				{
+					if (pc == target)
+					{
+						if (a == state[0] && x == state[1] && y == state[2] && sp == state[3] && flags.Pack() == state[4])
+						{
+							const Cycle length = cycles.count - start;
+
+							if (cycles.count < cycles.round)
+								cycles.count += (cycles.round - 1 - cycles.count) / length * length;
+						}
+						else
+						{
+							*reject = loop;
+						}
+					}
+
+					break;
+				}
+			}
+
+			idle.enabled = true;
+		}
+
 		////////////////////////////////////////////////////////////////////////////////////////
 		// main
 		////////////////////////////////////////////////////////////////////////////////////////
@@ -1869,15 +2605,32 @@ namespace Nes
 		{
 			NST_VERIFY( cycles.count < cycles.frame );
 
+			map.Validate();
 			apu.BeginFrame( sound );
 
 			Clock();
 
-			switch (hooks.Size())
+			// loops can only be skipped when no hook expects to see every instruction
+
+			idle.BeginFrame( !hooks.Size() );
+
+			if (code.ops)
 			{
-				case 0:  Run0(); break;
-				case 1:  Run1(); break;
-				default: Run2(); break;
+				switch (hooks.Size())
+				{
+					case 0:  Run0<true>(); break;
+					case 1:  Run1<true>(); break;
+					default: Run2<true>(); break;
+				}
+			}
+			else
+			{
+				switch (hooks.Size())
+				{
+					case 0:  Run0<false>(); break;
+					case 1:  Run1<false>(); break;
+					default: Run2<false>(); break;
+				}
 			}
 		}
 
@@ -1885,8 +2638,15 @@ namespace Nes
 		{
 			apu.EndFrame();
 
-			for (const Hook *hook = hooks.Ptr(), *const end = hook+hooks.Size(); hook != end; ++hook)
-				hook->Execute();
+			{
+				NST_PROFILE_SCOPE( STAGE_HOOKS );
+				NST_PROFILE_COUNT_N( HOOKS, hooks.Size() );
+
+				for (const Hook *hook = hooks.Ptr(), *const end = hook+hooks.Size(); hook != end; ++hook)
+					hook->Execute();
+			}
+
+			events.Flush();
 
 			NST_ASSERT( cycles.count >= cycles.frame && interrupt.nmiClock >= cycles.frame );
 
@@ -1902,11 +2662,17 @@ namespace Nes
 
 		void Cpu::Clock()
 		{
+			if (cycles.count >= events.next)
+				events.Execute( cycles.count );
+
 			Cycle clock = apu.Clock();
 
 			if (clock > cycles.frame)
 				clock = cycles.frame;
 
+			if (clock > events.next)
+				clock = events.next;
+
 			if (cycles.count < interrupt.nmiClock)
 			{
 				if (clock > interrupt.nmiClock)
@@ -1939,17 +2705,49 @@ namespace Nes
 
 		inline void Cpu::ExecuteOp()
 		{
+			NST_PROFILE_COUNT( INSTRUCTIONS );
+
 			cycles.offset = cycles.count;
 			(*this.*opcodes[opcode=FetchPc8()])();
 		}
 
+		inline void Cpu::ExecuteCode()
+		{
+			NST_PROFILE_COUNT( INSTRUCTIONS );
+
+			cycles.offset = cycles.count;
+
+			if (const byte* const mem = map.Direct( pc ))
+			{
+				const dword offset = dword(mem - code.rom);
+
+				if (offset < code.size && code.ops[offset].length)
+				{
+					const Code::Op& op = code.ops[offset];
+
+					opcode = op.code;
+					operand = op.operand;
+					pc += op.length;
+
+					(*this.*decoders[opcode])();
+					return;
+				}
+			}
+
+			(*this.*opcodes[opcode=FetchPc8()])();
+		}
+
+		template<bool CODE>
 		void Cpu::Run0()
 		{
 			do
 			{
 				do
 				{
-					ExecuteOp();
+					if (CODE)
+						ExecuteCode();
+					else
+						ExecuteOp();
 				}
 				while (cycles.count < cycles.round);
 
@@ -1958,6 +2756,7 @@ namespace Nes
 			while (cycles.count < cycles.frame);
 		}
 
+		template<bool CODE>
 		void Cpu::Run1()
 		{
 			const Hook hook( *hooks.Ptr() );
@@ -1966,7 +2765,13 @@ namespace Nes
 			{
 				do
 				{
-					ExecuteOp();
+					if (CODE)
+						ExecuteCode();
+					else
+						ExecuteOp();
+
+					NST_PROFILE_COUNT( HOOKS );
+
 					hook.Execute();
 				}
 				while (cycles.count < cycles.round);
@@ -1976,6 +2781,7 @@ namespace Nes
 			while (cycles.count < cycles.frame);
 		}
 
+		template<bool CODE>
 		void Cpu::Run2()
 		{
 			const Hook* const first = hooks.Ptr();
@@ -1985,7 +2791,12 @@ namespace Nes
 			{
 				do
 				{
-					ExecuteOp();
+					if (CODE)
+						ExecuteCode();
+					else
+						ExecuteOp();
+
+					NST_PROFILE_COUNT_N( HOOKS, dword(last - first) + 1 );
 
 					const Hook* NST_RESTRICT hook = first;
 
@@ -2014,6 +2825,280 @@ namespace Nes
 			return map.Poke8( address, data );
 		}
 
+		////////////////////////////////////////////////////////////////////////////////////////
+		// decoded code, operand and pc already fetched from the code cache
+		////////////////////////////////////////////////////////////////////////////////////////
+
+		inline uint Cpu::CodeAbsReg_R(uint indexed)
+		{
+			indexed += operand & 0xFF;
+			uint data = (operand & 0xFF00) + indexed;
+			cycles.count += cycles.clock[2];
+
+			if (indexed & 0x100)
+			{
+				map.Peek8( data - 0x100 );
+				cycles.count += cycles.clock[0];
+			}
+
+			data = map.Peek8( data );
+			cycles.count += cycles.clock[0];
+
+			return data;
+		}
+
+		inline uint Cpu::CodeAbsReg_RW(uint& data,uint indexed)
+		{
+			indexed += operand & 0xFF;
+			const uint address = (operand & 0xFF00) + indexed;
+
+			map.Peek8( address - (indexed & 0x100) );
+			cycles.count += cycles.clock[3];
+
+			data = map.Peek8( address );
+			cycles.count += cycles.clock[0];
+
+			map.Poke8( address, data );
+			cycles.count += cycles.clock[0];
+
+			return address;
+		}
+
+		inline uint Cpu::CodeAbsReg_W(uint indexed)
+		{
+			indexed += operand & 0xFF;
+			const uint address = (operand & 0xFF00) + indexed;
+
+			map.Peek8( address - (indexed & 0x100) );
+			cycles.count += cycles.clock[3];
+
+			return address;
+		}
+
+		template<Cpu::CodeRead INSTR>
+		void Cpu::CodeImm_R()
+		{
+			cycles.count += cycles.clock[1];
+			(*this.*INSTR)( operand );
+		}
+
+		template<Cpu::CodeRead INSTR>
+		void Cpu::CodeZpg_R()
+		{
+			cycles.count += cycles.clock[2];
+			(*this.*INSTR)( ram.mem[operand] );
+		}
+
+		template<Cpu::CodeRead INSTR>
+		void Cpu::CodeZpgX_R()
+		{
+			cycles.count += cycles.clock[3];
+			(*this.*INSTR)( ram.mem[(operand + x) & 0xFF] );
+		}
+
+		template<Cpu::CodeRead INSTR>
+		void Cpu::CodeZpgY_R()
+		{
+			cycles.count += cycles.clock[3];
+			(*this.*INSTR)( ram.mem[(operand + y) & 0xFF] );
+		}
+
+		template<Cpu::CodeRead INSTR>
+		void Cpu::CodeAbs_R()
+		{
+			cycles.count += cycles.clock[2];
+			const uint data = map.Peek8( operand );
+			cycles.count += cycles.clock[0];
+			(*this.*INSTR)( data );
+		}
+
+		template<Cpu::CodeRead INSTR>
+		void Cpu::CodeAbsX_R()
+		{
+			(*this.*INSTR)( CodeAbsReg_R( x ) );
+		}
+
+		template<Cpu::CodeRead INSTR>
+		void Cpu::CodeAbsY_R()
+		{
+			(*this.*INSTR)( CodeAbsReg_R( y ) );
+		}
+
+		template<Cpu::CodeRead INSTR>
+		void Cpu::CodeIndX_R()
+		{
+			cycles.count += cycles.clock[4];
+			const uint data = map.Peek8( FetchZpg16( operand + x ) );
+			cycles.count += cycles.clock[0];
+			(*this.*INSTR)( data );
+		}
+
+		template<Cpu::CodeRead INSTR>
+		void Cpu::CodeIndY_R()
+		{
+			cycles.count += cycles.clock[3];
+
+			const uint indexed = ram.mem[operand] + y;
+			uint data = (uint(ram.mem[(operand + 1) & 0xFF]) << 8) + indexed;
+
+			if (indexed & 0x100)
+			{
+				map.Peek8( data - 0x100 );
+				cycles.count += cycles.clock[0];
+			}
+
+			data = map.Peek8( data );
+			cycles.count += cycles.clock[0];
+
+			(*this.*INSTR)( data );
+		}
+
+		template<Cpu::CodeWrite INSTR>
+		void Cpu::CodeZpg_W()
+		{
+			cycles.count += cycles.clock[2];
+			StoreZpg( operand, (*this.*INSTR)() );
+		}
+
+		template<Cpu::CodeWrite INSTR>
+		void Cpu::CodeZpgX_W()
+		{
+			cycles.count += cycles.clock[3];
+			StoreZpg( (operand + x) & 0xFF, (*this.*INSTR)() );
+		}
+
+		template<Cpu::CodeWrite INSTR>
+		void Cpu::CodeZpgY_W()
+		{
+			cycles.count += cycles.clock[3];
+			StoreZpg( (operand + y) & 0xFF, (*this.*INSTR)() );
+		}
+
+		template<Cpu::CodeWrite INSTR>
+		void Cpu::CodeAbs_W()
+		{
+			cycles.count += cycles.clock[2];
+			StoreMem( operand, (*this.*INSTR)() );
+		}
+
+		template<Cpu::CodeWrite INSTR>
+		void Cpu::CodeAbsX_W()
+		{
+			const uint address = CodeAbsReg_W( x );
+			StoreMem( address, (*this.*INSTR)() );
+		}
+
+		template<Cpu::CodeWrite INSTR>
+		void Cpu::CodeAbsY_W()
+		{
+			const uint address = CodeAbsReg_W( y );
+			StoreMem( address, (*this.*INSTR)() );
+		}
+
+		template<Cpu::CodeWrite INSTR>
+		void Cpu::CodeIndX_W()
+		{
+			cycles.count += cycles.clock[4];
+			StoreMem( FetchZpg16( operand + x ), (*this.*INSTR)() );
+		}
+
+		template<Cpu::CodeWrite INSTR>
+		void Cpu::CodeIndY_W()
+		{
+			cycles.count += cycles.clock[4];
+
+			const uint indexed = ram.mem[operand] + y;
+			const uint address = (uint(ram.mem[(operand + 1) & 0xFF]) << 8) + indexed;
+
+			map.Peek8( address - (indexed & 0x100) );
+
+			StoreMem( address, (*this.*INSTR)() );
+		}
+
+		template<Cpu::CodeModify INSTR>
+		void Cpu::CodeZpg_RW()
+		{
+			cycles.count += cycles.clock[4];
+			StoreZpg( operand, (*this.*INSTR)( ram.mem[operand] ) );
+		}
+
+		template<Cpu::CodeModify INSTR>
+		void Cpu::CodeZpgX_RW()
+		{
+			const uint address = (operand + x) & 0xFF;
+			cycles.count += cycles.clock[5];
+			StoreZpg( address, (*this.*INSTR)( ram.mem[address] ) );
+		}
+
+		template<Cpu::CodeModify INSTR>
+		void Cpu::CodeAbs_RW()
+		{
+			cycles.count += cycles.clock[2];
+
+			const uint data = map.Peek8( operand );
+			cycles.count += cycles.clock[0];
+
+			map.Poke8( operand, data );
+			cycles.count += cycles.clock[0];
+
+			StoreMem( operand, (*this.*INSTR)( data ) );
+		}
+
+		template<Cpu::CodeModify INSTR>
+		void Cpu::CodeAbsX_RW()
+		{
+			uint data;
+			const uint address = CodeAbsReg_RW( data, x );
+			StoreMem( address, (*this.*INSTR)( data ) );
+		}
+
+		template<bool STATE>
+		NST_FORCE_INLINE void Cpu::CodeBranch(uint tmp)
+		{
+			if ((!!tmp) == STATE)
+			{
+				tmp = pc;
+				pc = (pc + sign_extend_8(operand)) & 0xFFFF;
+				cycles.count += cycles.clock[2 + ((tmp^pc) >> 8 & 1)];
+
+				if ((operand & 0x80) && idle.enabled)
+					SkipIdle( tmp - 2 );
+			}
+			else
+			{
+				cycles.count += cycles.clock[1];
+			}
+		}
+
+		void Cpu::CodeBne() { CodeBranch< true  >( flags.nz & 0xFF  ); }
+		void Cpu::CodeBeq() { CodeBranch< false >( flags.nz & 0xFF  ); }
+		void Cpu::CodeBmi() { CodeBranch< true  >( flags.nz & 0x180 ); }
+		void Cpu::CodeBpl() { CodeBranch< false >( flags.nz & 0x180 ); }
+		void Cpu::CodeBcs() { CodeBranch< true  >( flags.c          ); }
+		void Cpu::CodeBcc() { CodeBranch< false >( flags.c          ); }
+		void Cpu::CodeBvs() { CodeBranch< true  >( flags.v          ); }
+		void Cpu::CodeBvc() { CodeBranch< false >( flags.v          ); }
+
+		void Cpu::CodeJmpAbs()
+		{
+			const uint address = pc - 3;
+
+			pc = operand;
+			cycles.count += cycles.clock[JMP_ABS_CYCLES-1];
+
+			if (pc <= address && idle.enabled)
+				SkipIdle( address );
+		}
+
+		void Cpu::CodeJsr()
+		{
+			// same return address as Jsr(), one byte prior to the next instruction
+
+			Push16( pc - 1 );
+			pc = operand;
+			cycles.count += cycles.clock[JSR_CYCLES-1];
+		}
+
 		////////////////////////////////////////////////////////////////////////////////////////
 		// opcodes
 		////////////////////////////////////////////////////////////////////////////////////////
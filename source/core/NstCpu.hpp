@@ -88,13 +88,18 @@ namespace Nes
 			void SetModel(CpuModel);
 			void AddHook(const Hook&);
 			void RemoveHook(const Hook&);
+			void AddEvent(const Hook&);
+			void ScheduleEvent(const Hook&,Cycle);
+			void MapCode(const byte*,dword);
+			void EnableCodeCache(bool);
+			void SetIdleRange(Address,Address);
 
 			void SaveState(State::Saver&,dword,dword) const;
 			void LoadState(State::Loader&,dword,dword,dword);
 
 		private:
 
-			static void NotifyOp(const char (&)[4],dword);
+			void NotifyOp(const char (&)[4],dword);
 
 			enum
 			{
@@ -128,11 +133,12 @@ namespace Nes
 			uint FetchIRQISRVector();
 			void Clock();
 
-			void Run0();
-			void Run1();
-			void Run2();
+			template<bool CODE> void Run0();
+			template<bool CODE> void Run1();
+			template<bool CODE> void Run2();
 
 			inline void ExecuteOp();
+			inline void ExecuteCode();
 			inline uint FetchPc8();
 			inline uint FetchPc16();
 			inline uint FetchZpg16(uint) const;
@@ -153,6 +159,10 @@ namespace Nes
 			template<bool STATE>
 			NST_FORCE_INLINE void Branch(uint);
 
+			bool IsIdleRead(uint) const;
+			bool IsIdleOp(uint) const;
+			NST_NO_INLINE void SkipIdle(uint);
+
 			inline uint Imm_R  ();
 			inline uint Zpg_R  ();
 			inline uint ZpgX_R ();
@@ -279,6 +289,53 @@ namespace Nes
 			NST_SINGLE_CALL void Brk ();
 			NST_NO_INLINE void Jam ();
 
+			typedef void (Cpu::*CodeRead)(uint);
+			typedef uint (Cpu::*CodeWrite)() const;
+			typedef uint (Cpu::*CodeModify)(uint);
+
+			template<CodeRead>   void CodeImm_R  ();
+			template<CodeRead>   void CodeZpg_R  ();
+			template<CodeRead>   void CodeZpgX_R ();
+			template<CodeRead>   void CodeZpgY_R ();
+			template<CodeRead>   void CodeAbs_R  ();
+			template<CodeRead>   void CodeAbsX_R ();
+			template<CodeRead>   void CodeAbsY_R ();
+			template<CodeRead>   void CodeIndX_R ();
+			template<CodeRead>   void CodeIndY_R ();
+
+			template<CodeWrite>  void CodeZpg_W  ();
+			template<CodeWrite>  void CodeZpgX_W ();
+			template<CodeWrite>  void CodeZpgY_W ();
+			template<CodeWrite>  void CodeAbs_W  ();
+			template<CodeWrite>  void CodeAbsX_W ();
+			template<CodeWrite>  void CodeAbsY_W ();
+			template<CodeWrite>  void CodeIndX_W ();
+			template<CodeWrite>  void CodeIndY_W ();
+
+			template<CodeModify> void CodeZpg_RW  ();
+			template<CodeModify> void CodeZpgX_RW ();
+			template<CodeModify> void CodeAbs_RW  ();
+			template<CodeModify> void CodeAbsX_RW ();
+
+			inline uint CodeAbsReg_R  (uint);
+			inline uint CodeAbsReg_RW (uint&,uint);
+			inline uint CodeAbsReg_W  (uint);
+
+			template<bool STATE>
+			NST_FORCE_INLINE void CodeBranch(uint);
+
+			void CodeBcc ();
+			void CodeBcs ();
+			void CodeBeq ();
+			void CodeBmi ();
+			void CodeBne ();
+			void CodeBpl ();
+			void CodeBvc ();
+			void CodeBvs ();
+
+			void CodeJmpAbs ();
+			void CodeJsr    ();
+
 			void op0x00(); void op0x01(); void op0x02(); void op0x03();
 			void op0x04(); void op0x05(); void op0x06(); void op0x07();
 			void op0x08(); void op0x09(); void op0x0A(); void op0x0B();
@@ -416,6 +473,85 @@ namespace Nes
 				word capacity;
 			};
 
+			class Events
+			{
+			public:
+
+				Events();
+				~Events();
+
+				void Add(const Hook&);
+				void Schedule(const Hook&,Cycle);
+				void Execute(Cycle);
+				void Flush();
+				void Clear();
+
+			private:
+
+				struct Event;
+
+				Event* events;
+				word size;
+				word capacity;
+
+			public:
+
+				Cycle next;
+			};
+
+			class Code
+			{
+			public:
+
+				Code();
+				~Code();
+
+				enum
+				{
+					BANK_SIZE = SIZE_8K
+				};
+
+				void Map(const byte*,dword);
+				void Enable(bool);
+
+				struct Op
+				{
+					word operand;
+					byte code;
+					byte length;
+				};
+
+			private:
+
+				void Decode();
+
+				static const byte lengths[0x100];
+
+			public:
+
+				const byte* rom;
+				dword size;
+				Op* ops;
+				bool enabled;
+			};
+
+			struct Idle
+			{
+				void Reset();
+				void BeginFrame(bool);
+
+				enum
+				{
+					MAX_OPS = 16,
+					NUM_REJECTS = 16
+				};
+
+				bool enabled;
+				uint first;
+				uint last;
+				dword rejects[NUM_REJECTS];
+			};
+
 			struct Ram
 			{
 				typedef byte (&Ref)[RAM_SIZE];
@@ -432,17 +568,52 @@ namespace Nes
 				NES_DECL_PEEK( Ram_3 );
 				NES_DECL_POKE( Ram_3 );
 
+				const byte* bank;
 				byte mem[RAM_SIZE];
 			};
 
-			struct IoMap : Io::Map<SIZE_64K>
+			class IoMap : public Io::Map<SIZE_64K>
 			{
+			public:
+
 				template<typename T,typename U>
 				IoMap(Cpu*,T,U);
 
+				enum
+				{
+					PAGE_SHIFT = 8,
+					PAGE_SIZE = 1U << PAGE_SHIFT,
+					NUM_PAGES = SIZE / PAGE_SIZE
+				};
+
 				inline uint Peek8(uint) const;
 				inline uint Peek16(uint) const;
 				inline void Poke8(uint,uint) const;
+				inline const byte* Direct(uint) const;
+
+				void SetMemory(Address,Address,const byte* const*,uint,const Io::Port&);
+				void ClearMemory();
+				void Invalidate(Address,Address);
+				void Validate();
+
+			private:
+
+				struct Page
+				{
+					const byte* const* mem;
+					uint mask;
+				};
+
+				struct Source
+				{
+					const byte* const* mem;
+					uint mask;
+					Io::Port port;
+				};
+
+				Page pages[NUM_PAGES+1];
+				Source sources[NUM_PAGES];
+				bool dirty;
 			};
 
 			class Linker
@@ -477,7 +648,9 @@ namespace Nes
 			Flags flags;
 			Interrupt interrupt;
 			Hooks hooks;
+			Events events;
 			uint opcode;
+			uint operand;
 			word jammed;
 			word model;
 			Linker linker;
@@ -485,9 +658,12 @@ namespace Nes
 			Ram ram;
 			Apu apu;
 			IoMap map;
+			Code code;
+			Idle idle;
+			dword logged;
 
-			static dword logged;
 			static void (Cpu::*const opcodes[0x100])();
+			static void (Cpu::*const decoders[0x100])();
 			static const byte writeClocks[0x100];
 
 		public:
@@ -523,6 +699,11 @@ namespace Nes
 				return interrupt.low;
 			}
 
+			bool IsJammed() const
+			{
+				return jammed;
+			}
+
 			CpuModel GetModel() const
 			{
 				return static_cast<CpuModel>(model);
@@ -560,6 +741,11 @@ namespace Nes
 				cycles.NextRound( count );
 			}
 
+			bool IsCodeCacheEnabled() const
+			{
+				return code.enabled;
+			}
+
 			Ram::Ref GetRam()
 			{
 				return ram.mem;
@@ -572,23 +758,33 @@ namespace Nes
 
 			Io::Port& Map(Address address)
 			{
+				map.Invalidate( address, address );
 				return map( address );
 			}
 
 			IoMap::Section Map(Address first,Address last)
 			{
+				map.Invalidate( first, last );
 				return map( first, last );
 			}
 
+			template<typename T,typename U,typename V>
+			void MapMemory(Address first,Address last,const byte* const* mem,uint mask,T t,U u,V v)
+			{
+				map.SetMemory( first, last, mem, mask, Io::Port(t,u,v) );
+			}
+
 			template<typename T,typename U,typename V>
 			const Io::Port* Link(Address address,Level level,T t,U u,V v)
 			{
+				map.Invalidate( address, address );
 				return linker.Add( address, level, Io::Port(t,u,v), map );
 			}
 
 			template<typename T,typename U,typename V>
 			void Unlink(Address address,T t,U u,V v)
 			{
+				map.Invalidate( address, address );
 				linker.Remove( address, Io::Port(t,u,v), map );
 			}
 		};
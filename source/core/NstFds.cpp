@@ -402,6 +402,16 @@ namespace Nes
 			return RESULT_ERR_INVALID_PARAM;
 		}
 
+		Result Fds::EnableFastLoad(const bool enable)
+		{
+			if (adapter.IsFastLoadEnabled() == enable)
+				return RESULT_NOP;
+
+			adapter.EnableFastLoad( enable );
+
+			return RESULT_OK;
+		}
+
 		void Fds::LoadState(State::Loader& state)
 		{
 			uint saveDisks[3] = {~0U,~0U,~0U};
@@ -858,7 +868,7 @@ namespace Nes
 		#endif
 
 		Fds::Unit::Drive::Drive(const Disks::Sides& s)
-		: sides(s)
+		: fast(false), sides(s)
 		{
 			Reset();
 		}
@@ -1028,11 +1038,21 @@ namespace Nes
 			}
 			else if (!(reg & CTRL_STOP | count) && io)
 			{
-				count = CLK_MOTOR;
+				count = fast ? CLK_FAST : CLK_MOTOR;
 				headPos = 0;
 			}
 		}
 
+		NST_SINGLE_CALL void Fds::Unit::Drive::Acknowledge()
+		{
+			// In fast-load mode the next byte of a block being read follows
+			// shortly after the current one was taken, instead of at the
+			// disk's rate. Writes and gaps keep their real timing.
+
+			if (fast && count > CLK_FAST && !gap && (ctrl & uint(CTRL_READ_MODE)))
+				count = CLK_FAST;
+		}
+
 		ibool Fds::Unit::Drive::Advance(uint& timer)
 		{
 			NST_ASSERT( io && !count );
@@ -1100,6 +1120,11 @@ namespace Nes
 					}
 					else
 					{
+						// skip the rest of the gap once the BIOS waits for the next block
+
+						if (fast && (ctrl & uint(CTRL_IO_MODE)))
+							gap = 1;
+
 						if (!--gap)
 						{
 							NST_VERIFY( *stream <= 4 );
@@ -1209,7 +1234,7 @@ namespace Nes
 			}
 			else if (headPos)
 			{
-				count = CLK_REWIND;
+				count = fast ? CLK_FAST : CLK_REWIND;
 				headPos = 0;
 				status |= uint(STATUS_UNREADY);
 			}
@@ -1262,6 +1287,17 @@ namespace Nes
 			);
 		}
 
+		uint Fds::Unit::Pending() const
+		{
+			const dword next[2] =
+			{
+				(timer.ctrl & Timer::CTRL_ENABLED) ? timer.count : 0,
+				drive.count
+			};
+
+			return (next[0] && next[1]) ? NST_MIN(next[0],next[1]) : (next[0] | next[1]);
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("s", on)
 		#endif
@@ -1320,7 +1356,7 @@ namespace Nes
 					unit.drive.count >> 0 & 0xFF,
 					unit.drive.count >> 8 & 0xFF,
 					unit.drive.count >> 16,
-					unit.drive.in >> 8
+					unit.drive.in >> 8 | (unit.drive.fast ? 0x2U : 0x0U)
 				};
 
 				state.Begin( AsciiId<'D','R','V'>::V ).Write( data ).End();
@@ -1356,6 +1392,7 @@ namespace Nes
 					unit.drive.gap = data[8] | data[9] << 8;
 					unit.drive.length = data[10] | data[11] << 8;
 					unit.drive.count = data[12] | data[13] << 8 | dword(data[14]) << 16;
+					unit.drive.fast = data[15] >> 1 & 0x1;
 
 					if (unit.drive.dataPos > SIDE_SIZE)
 						unit.drive.dataPos = SIDE_SIZE;
@@ -1369,6 +1406,17 @@ namespace Nes
 			}
 		}
 
+		void Fds::Adapter::EnableFastLoad(const bool enable)
+		{
+			Update();
+			unit.drive.fast = enable;
+		}
+
+		bool Fds::Adapter::IsFastLoadEnabled() const
+		{
+			return unit.drive.fast;
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("", on)
 		#endif
@@ -1404,6 +1452,8 @@ namespace Nes
 			if (!unit.status)
 				ClearIRQ();
 
+			unit.drive.Acknowledge();
+
 			return unit.drive.in;
 		}
 
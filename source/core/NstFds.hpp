@@ -52,6 +52,7 @@ namespace Nes
 			Result InsertDisk(uint,uint);
 			Result EjectDisk();
 			Result GetDiskData(uint,Api::Fds::DiskData&) const;
+			Result EnableFastLoad(bool);
 
 			static void SetBios(std::istream*);
 			static Result GetBios(std::ostream&);
@@ -277,7 +278,7 @@ namespace Nes
 				};
 
 				struct fds_manufacturer_code {
-					uint8_t code;
+					byte code;
 					const char *name;
 					const char *jpname;
 				};
@@ -379,6 +380,7 @@ namespace Nes
 
 				void Reset(bool);
 				ibool Clock();
+				uint Pending() const;
 
 				enum
 				{
@@ -418,6 +420,7 @@ namespace Nes
 
 					NST_SINGLE_CALL bool Clock();
 					NST_SINGLE_CALL void Write(uint);
+					NST_SINGLE_CALL void Acknowledge();
 
 					enum
 					{
@@ -430,6 +433,7 @@ namespace Nes
 
 						CLK_MOTOR  = CLK_HEAD/8UL * 100 * CLK_BYTE / 1000,
 						CLK_REWIND = CLK_HEAD/8UL * 135 * CLK_BYTE / 1000,
+						CLK_FAST   = CLK_BYTE / 4,
 
 						CTRL_ON        = 0x01,
 						CTRL_STOP      = 0x02,
@@ -463,6 +467,7 @@ namespace Nes
 					byte out;
 					byte ctrl;
 					byte status;
+					ibool fast;
 					const Disks::Sides& sides;
 				};
 
@@ -497,6 +502,9 @@ namespace Nes
 				NST_SINGLE_CALL void WriteProtect();
 				NST_SINGLE_CALL uint Activity() const;
 
+				void EnableFastLoad(bool);
+				bool IsFastLoadEnabled() const;
+
 				using Timer::M2<Unit>::VSync;
 			};
 
@@ -571,6 +579,11 @@ namespace Nes
 			{
 				return disks.sides.HasHeader();
 			}
+
+			bool IsFastLoadEnabled() const
+			{
+				return adapter.IsFastLoadEnabled();
+			}
 		};
 	}
 }
@@ -30,6 +30,7 @@
 #include <map>
 #include <algorithm>
 #include "NstLog.hpp"
+#include "NstStream.hpp"
 #include "NstImageDatabase.hpp"
 #include "NstXml.hpp"
 
@@ -37,12 +38,34 @@ namespace Nes
 {
 	namespace Core
 	{
+		struct ImageDatabase::Header
+		{
+			enum
+			{
+				VERSION = 2,
+				ENDIAN = 0x01020304
+			};
+
+			static const byte magic[4];
+
+			byte id[4];
+			dword order;
+			dword version;
+			dword charSize;
+			dword itemSize;
+			dword hashing;
+			dword size;
+			dword items;
+			dword records;
+			dword strings;
+		};
+
+		const byte ImageDatabase::Header::magic[4] = {'N','D','B',0x1A};
+
 		class ImageDatabase::Item
 		{
 		public:
 
-			~Item();
-
 			enum
 			{
 				PERIPHERAL_UNSPECIFIED,
@@ -76,313 +99,317 @@ namespace Nes
 				MAX_PERIPHERALS = 4
 			};
 
-		private:
-
-			class String
+			enum
 			{
-				union
-				{
-					mutable wcstring string;
-					dword id;
-				};
-
-			public:
-
-				explicit String(dword i=0)
-				: id(i) {}
-
-				bool operator == (const String& s) const
-				{
-					return id == s.id;
-				}
+				MULTI_REGION = 0x1,
+				WRAM_BATTERY = 0x2,
+				VRAM_BATTERY = 0x4,
+				CHIP_BATTERY = 0x8
+			};
 
-				bool operator < (const String& s) const
-				{
-					return id < s.id;
-				}
+			// All references are byte offsets from the start of the image
 
-				void operator << (wcstring s) const
-				{
-					string = s + id;
-				}
+			typedef dword String;
 
-				operator wcstring () const
-				{
-					return string;
-				}
+			struct Table
+			{
+				dword offset;
+				dword count;
 			};
 
-		public:
-
-			struct Ic
+			struct Pin
 			{
-				struct Pin
-				{
-					uint number;
-					String function;
-
-					Pin() {}
-
-					Pin(uint n,dword s)
-					: number(n), function(s) {}
-				};
-
-				typedef std::vector<Pin> Pins;
-
-				String package;
-				Pins pins;
-
-				Ic() {}
-
-				Ic(dword p,const Pins& i)
-				: package(p), pins(i) {}
+				dword number;
+				String function;
 			};
 
-			struct Rom : Ic
+			struct Rom
 			{
 				dword id;
 				String name;
+				String package;
 				dword size;
 				Hash hash;
-
-				Rom() {}
-
-				Rom(dword i,dword n,dword s,dword e,const Pins& p,const Hash& c)
-				: Ic(e,p), id(i), name(n), size(s), hash(c) {}
+				Table pins;
 			};
 
-			typedef std::vector<Rom> Roms;
-
-			struct Ram : Ic
+			struct Ram
 			{
 				dword id;
 				dword size;
-				bool battery;
+				dword battery;
+				String package;
+				Table pins;
+			};
 
-				Ram() {}
+			struct Chip
+			{
+				String type;
+				String package;
+				dword battery;
+				Table pins;
+			};
 
-				Ram(dword i,dword s,bool b,dword e,const Pins& p)
-				: Ic(e,p), id(i), size(s), battery(b) {}
+			struct Property
+			{
+				String name;
+				String value;
 			};
 
-			typedef std::vector<Ram> Rams;
+			Hash hash;
+			dword offset;
+			dword sibling;
+			String dumpBy;
+			String dumpDate;
+			String title;
+			String altTitle;
+			String clss;
+			String subClss;
+			String catalog;
+			String publisher;
+			String developer;
+			String portDeveloper;
+			String region;
+			String revision;
+			String pcb;
+			String board;
+			String cic;
+			Table prg;
+			Table chr;
+			Table wram;
+			Table vram;
+			Table chips;
+			Table properties;
+			dword prgSize;
+			dword chrSize;
+			dword wramSize;
+			dword vramSize;
+			word mapper;
+			byte solderPads;
+			byte system;
+			byte cpu;
+			byte ppu;
+			byte players;
+			byte dump;
+			byte flags;
+			byte peripherals[MAX_PERIPHERALS];
 
-			struct Chip : Ic
+		private:
+
+			const byte* Base() const
 			{
-				String type;
-				bool battery;
+				return reinterpret_cast<const byte*>(this) - offset;
+			}
 
-				Chip() {}
+			wcstring Get(String string) const
+			{
+				return reinterpret_cast<wcstring>(Base() + string);
+			}
 
-				Chip(dword id,bool b,dword e,const Pins& p)
-				: Ic(e,p), type(id), battery(b) {}
+			template<typename T>
+			const T* Get(const Table& table) const
+			{
+				return reinterpret_cast<const T*>(Base() + table.offset);
+			}
 
-				bool operator == (const Chip& chip) const
+			struct Bounds
+			{
+				dword strings;
+				dword tables;
+				dword size;
+
+				bool Check(String string) const
 				{
-					return type == chip.type;
+					return string - strings < tables - strings && string % sizeof(wchar_t) == 0;
 				}
 
-				bool operator < (const Chip& chip) const
+				template<typename T>
+				bool Check(const Table& table) const
 				{
-					return type < chip.type;
+					return !table.count ||
+					(
+						table.offset >= tables &&
+						table.offset <= size &&
+						table.offset % sizeof(dword) == 0 &&
+						table.count <= (size - table.offset) / sizeof(T)
+					);
 				}
 			};
 
-			typedef std::vector<Chip> Chips;
-
-			struct Dump
+			template<typename T>
+			bool CheckPins(const Bounds& bounds,const T& src) const
 			{
-				const String by;
-				const String date;
-				const Profile::Dump::State state;
+				if (!bounds.Check<Pin>(src.pins))
+					return false;
 
-				Dump(dword b,dword d,Profile::Dump::State o)
-				: by(b), date(d), state(o) {}
-			};
+				const Pin* const pins = Get<Pin>(src.pins);
 
-			struct Property
+				for (dword i=0; i < src.pins.count; ++i)
+				{
+					if (!bounds.Check( pins[i].function ))
+						return false;
+				}
+
+				return true;
+			}
+
+			bool CheckRoms(const Bounds& bounds,const Table& table) const
 			{
-				String name;
-				String value;
+				if (!bounds.Check<Rom>(table))
+					return false;
 
-				Property() {}
+				const Rom* const roms = Get<Rom>(table);
 
-				Property(dword n,dword v)
-				: name(n), value(v) {}
-			};
+				for (dword i=0; i < table.count; ++i)
+				{
+					if (!bounds.Check( roms[i].name ) || !bounds.Check( roms[i].package ) || !CheckPins( bounds, roms[i] ))
+						return false;
+				}
 
-			typedef std::vector<Property> Properties;
+				return true;
+			}
 
-		private:
+			bool CheckRams(const Bounds& bounds,const Table& table) const
+			{
+				if (!bounds.Check<Ram>(table))
+					return false;
 
-			const Hash hash;
-			Item* sibling;
-			const Dump dump;
-			const String title;
-			const String altTitle;
-			const String clss;
-			const String subClss;
-			const String catalog;
-			const String publisher;
-			const String developer;
-			const String portDeveloper;
-			const String region;
-			const String revision;
-			const String pcb;
-			const String board;
-			const String cic;
-			const Roms prg;
-			const Roms chr;
-			const Rams wram;
-			const Rams vram;
-			Chips chips;
-			const Properties properties;
-			byte peripherals[MAX_PERIPHERALS];
-			const word mapper;
-			const byte solderPads;
-			const byte system;
-			const byte cpu;
-			const byte ppu;
-			const byte players;
-			bool multiRegion;
+				const Ram* const rams = Get<Ram>(table);
 
-		public:
+				for (dword i=0; i < table.count; ++i)
+				{
+					if (!bounds.Check( rams[i].package ) || !CheckPins( bounds, rams[i] ))
+						return false;
+				}
 
-			Item
-			(
-				const Hash& hashIn,
-				dword dumpBy,
-				dword dumpDate,
-				Profile::Dump::State dumpState,
-				dword titleIn,
-				dword altTitleIn,
-				dword clssIn,
-				dword subClssIn,
-				dword catalogIn,
-				dword publisherIn,
-				dword developerIn,
-				dword portDeveloperIn,
-				dword regionIn,
-				const Properties& propertiesIn,
-				dword playersIn,
-				const byte (&e)[MAX_PERIPHERALS],
-				Profile::System::Type systemIn,
-				Profile::System::Cpu cpuIn,
-				Profile::System::Ppu ppuIn,
-				dword revisionIn,
-				dword boardIn,
-				dword pcbIn,
-				uint mapperIn,
-				const Roms& prgIn,
-				const Roms& chrIn,
-				const Rams& wramIn,
-				const Rams& vramIn,
-				const Chips& chipsIn,
-				dword cicIn,
-				uint solderPadsIn
-			)
-			:
-			hash          ( hashIn                      ),
-			sibling       ( NULL                        ),
-			dump          ( dumpBy, dumpDate, dumpState ),
-			title         ( titleIn                     ),
-			altTitle      ( altTitleIn                  ),
-			clss          ( clssIn                      ),
-			subClss       ( subClssIn                   ),
-			catalog       ( catalogIn                   ),
-			publisher     ( publisherIn                 ),
-			developer     ( developerIn                 ),
-			portDeveloper ( portDeveloperIn             ),
-			region        ( regionIn                    ),
-			revision      ( revisionIn                  ),
-			pcb           ( pcbIn                       ),
-			board         ( boardIn                     ),
-			cic           ( cicIn                       ),
-			prg           ( prgIn                       ),
-			chr           ( chrIn                       ),
-			wram          ( wramIn                      ),
-			vram          ( vramIn                      ),
-			chips         ( chipsIn                     ),
-			properties    ( propertiesIn                ),
-			mapper        ( mapperIn                    ),
-			solderPads    ( solderPadsIn                ),
-			system        ( systemIn                    ),
-			cpu           ( cpuIn                       ),
-			ppu           ( ppuIn                       ),
-			players       ( playersIn                   ),
-			multiRegion   ( false                       )
+				return true;
+			}
+
+			bool CheckChips(const Bounds& bounds) const
 			{
-				for (uint i=0; i < MAX_PERIPHERALS; ++i)
-					peripherals[i] = e[i];
+				if (!bounds.Check<Chip>(chips))
+					return false;
 
-				std::sort( chips.begin(), chips.end() );
-			}
+				const Chip* const items = Get<Chip>(chips);
 
-		private:
+				for (dword i=0; i < chips.count; ++i)
+				{
+					if (!bounds.Check( items[i].type ) || !bounds.Check( items[i].package ) || !CheckPins( bounds, items[i] ))
+						return false;
+				}
 
-			template<typename T>
-			static dword GetMemSize(const T& t)
+				return true;
+			}
+
+			bool CheckProperties(const Bounds& bounds) const
 			{
-				dword size = 0;
+				if (!bounds.Check<Property>(properties))
+					return false;
+
+				const Property* const items = Get<Property>(properties);
 
-				for (typename T::const_iterator it(t.begin()), end(t.end()); it != end; ++it)
-					size += it->size;
+				for (dword i=0; i < properties.count; ++i)
+				{
+					if (!bounds.Check( items[i].name ) || !bounds.Check( items[i].value ))
+						return false;
+				}
 
-				return size;
+				return true;
 			}
 
 			template<typename T>
-			static bool HasBattery(const T& t)
+			void Fill(Profile::Board::Pins& dst,const T& src) const
 			{
-				for (typename T::const_iterator it(t.begin()), end(t.end()); it != end; ++it)
+				dst.resize( src.pins.count );
+
+				const Pin* NST_RESTRICT pin = Get<Pin>(src.pins);
+
+				for (Profile::Board::Pins::iterator it(dst.begin()), end(dst.end()); it != end; ++it, ++pin)
 				{
-					if (it->battery)
-						return true;
+					it->number = pin->number;
+					it->function = Get(pin->function);
 				}
-
-				return false;
 			}
 
 		public:
 
+			// Checks that all references of a record mapped from a compiled
+			// image stay within the image, i.e. that it's safe to follow them.
+
+			bool IsValid(const dword position,const Header& header) const
+			{
+				const dword heads = sizeof(Header) + header.items * sizeof(Item);
+				const dword records = sizeof(Header) + header.records * sizeof(Item);
+
+				if (offset != position)
+					return false;
+
+				if (sibling && (sibling <= position || sibling < heads || sibling >= records || (sibling - sizeof(Header)) % sizeof(Item)))
+					return false;
+
+				const Bounds bounds = { records, records + header.strings, header.size };
+
+				const String strings[] =
+				{
+					dumpBy, dumpDate, title, altTitle, clss, subClss, catalog, publisher,
+					developer, portDeveloper, region, revision, pcb, board, cic
+				};
+
+				for (uint i=0; i < sizeof(array(strings)); ++i)
+				{
+					if (!bounds.Check( strings[i] ))
+						return false;
+				}
+
+				return
+				(
+					CheckRoms( bounds, prg ) &&
+					CheckRoms( bounds, chr ) &&
+					CheckRams( bounds, wram ) &&
+					CheckRams( bounds, vram ) &&
+					CheckChips( bounds ) &&
+					CheckProperties( bounds )
+				);
+			}
+
 			wcstring GetTitle() const
 			{
-				return title;
+				return Get( title );
 			}
 
 			wcstring GetPublisher() const
 			{
-				return publisher;
+				return Get( publisher );
 			}
 
 			wcstring GetDeveloper() const
 			{
-				return developer;
+				return Get( developer );
 			}
 
 			wcstring GetRegion() const
 			{
-				return region;
+				return Get( region );
 			}
 
 			wcstring GetRevision() const
 			{
-				return revision;
+				return Get( revision );
 			}
 
 			wcstring GetPcb() const
 			{
-				return pcb;
+				return Get( pcb );
 			}
 
 			wcstring GetBoard() const
 			{
-				return board;
+				return Get( board );
 			}
 
 			wcstring GetCic() const
 			{
-				return cic;
+				return Get( cic );
 			}
 
 			uint NumPlayers() const
@@ -407,7 +434,7 @@ namespace Nes
 
 			Profile::Dump::State GetDumpState() const
 			{
-				return dump.state;
+				return static_cast<Profile::Dump::State>(dump);
 			}
 
 			const Hash& GetHash() const
@@ -417,115 +444,100 @@ namespace Nes
 
 			dword GetPrgSize() const
 			{
-				return GetMemSize( prg );
+				return prgSize;
 			}
 
 			dword GetChrSize() const
 			{
-				return GetMemSize( chr );
+				return chrSize;
 			}
 
 			dword GetWramSize() const
 			{
-				return GetMemSize( wram );
+				return wramSize;
 			}
 
 			dword GetVramSize() const
 			{
-				return GetMemSize( vram );
-			}
-
-			bool HasVRamBattery() const
-			{
-				return HasBattery( vram );
-			}
-
-			bool HasWRamBattery() const
-			{
-				return HasBattery( wram );
-			}
-
-			bool HasChipBattery() const
-			{
-				return HasBattery( chips );
+				return vramSize;
 			}
 
 			bool HasBattery() const
 			{
-				return HasWRamBattery() || HasVRamBattery() || HasChipBattery();
+				return flags & (WRAM_BATTERY|VRAM_BATTERY|CHIP_BATTERY);
 			}
 
 			const Item* GetNextSibling() const
 			{
-				return sibling;
+				return sibling ? reinterpret_cast<const Item*>(Base() + sibling) : NULL;
 			}
 
 			bool IsMultiRegion() const
 			{
-				return multiRegion;
+				return flags & MULTI_REGION;
 			}
 
 			void Fill(Profile& profile,const bool full) const
 			{
 				if (full)
 				{
-					if (*dump.by)
-						profile.dump.by = dump.by;
+					if (*Get(dumpBy))
+						profile.dump.by = Get(dumpBy);
 
-					if (*dump.date)
-						profile.dump.date = dump.date;
+					if (*Get(dumpDate))
+						profile.dump.date = Get(dumpDate);
 
-					if (dump.state != Profile::Dump::UNKNOWN)
-						profile.dump.state = dump.state;
+					if (dump != Profile::Dump::UNKNOWN)
+						profile.dump.state = static_cast<Profile::Dump::State>(dump);
 
-					if (*title)
-						profile.game.title = title;
+					if (*Get(title))
+						profile.game.title = Get(title);
 
-					if (*altTitle)
-						profile.game.altTitle = altTitle;
+					if (*Get(altTitle))
+						profile.game.altTitle = Get(altTitle);
 
-					if (*clss)
-						profile.game.clss = clss;
+					if (*Get(clss))
+						profile.game.clss = Get(clss);
 
-					if (*subClss)
-						profile.game.subClss = subClss;
+					if (*Get(subClss))
+						profile.game.subClss = Get(subClss);
 
-					if (*catalog)
-						profile.game.catalog = catalog;
+					if (*Get(catalog))
+						profile.game.catalog = Get(catalog);
 
-					if (*publisher)
-						profile.game.publisher = publisher;
+					if (*Get(publisher))
+						profile.game.publisher = Get(publisher);
 
-					if (*developer)
-						profile.game.developer = developer;
+					if (*Get(developer))
+						profile.game.developer = Get(developer);
 
-					if (*portDeveloper)
-						profile.game.portDeveloper = portDeveloper;
+					if (*Get(portDeveloper))
+						profile.game.portDeveloper = Get(portDeveloper);
 
-					if (*region)
-						profile.game.region = region;
+					if (*Get(region))
+						profile.game.region = Get(region);
 
-					if (*revision)
-						profile.game.revision = revision;
+					if (*Get(revision))
+						profile.game.revision = Get(revision);
 
 					if (players)
 						profile.game.players = players;
 
-					if (*cic)
-						profile.board.cic = cic;
+					if (*Get(cic))
+						profile.board.cic = Get(cic);
 
-					if (*pcb)
-						profile.board.pcb = pcb;
+					if (*Get(pcb))
+						profile.board.pcb = Get(pcb);
 
-					if (const dword size = properties.size())
+					if (properties.count)
 					{
-						profile.properties.resize( size );
+						profile.properties.resize( properties.count );
 
-						Profile::Properties::iterator b(profile.properties.begin());
-						for (Properties::const_iterator a(properties.begin()), end(properties.end()); a != end; ++a, ++b)
+						const Property* NST_RESTRICT a = Get<Property>(properties);
+						for (Profile::Properties::iterator b(profile.properties.begin()), end(profile.properties.end()); b != end; ++a, ++b)
 						{
-							b->name = a->name;
-							b->value = a->value;
+							b->name = Get(a->name);
+							b->value = Get(a->value);
 						}
 					}
 				}
@@ -696,14 +708,14 @@ namespace Nes
 					}
 				}
 
-				profile.multiRegion = multiRegion;
+				profile.multiRegion = IsMultiRegion();
 
 				profile.system.type = static_cast<Profile::System::Type>(system);
 				profile.system.cpu = static_cast<Profile::System::Cpu>(cpu);
 				profile.system.ppu = static_cast<Profile::System::Ppu>(ppu);
 
-				if (*board)
-					profile.board.type = board;
+				if (*Get(board))
+					profile.board.type = Get(board);
 
 				if (mapper != Profile::Board::NO_MAPPER)
 					profile.board.mapper = mapper;
@@ -712,295 +724,439 @@ namespace Nes
 
 				for (uint j=0; j < 2; ++j)
 				{
-					if (full || (j ? profile.board.GetChr() == GetChrSize() : profile.board.GetPrg() == GetPrgSize()))
+					if (full || (j ? profile.board.GetChr() == chrSize : profile.board.GetPrg() == prgSize))
 					{
-						const Roms& src = (j ? chr : prg);
+						const Table& src = (j ? chr : prg);
 						Profile::Board::Roms& dst = (j ? profile.board.chr : profile.board.prg);
 
-						dst.resize( src.size() );
+						dst.resize( src.count );
 
-						Profile::Board::Roms::iterator b(dst.begin());
-						for (Roms::const_iterator a(src.begin()), end(src.end()); a != end; ++a, ++b)
+						const Rom* NST_RESTRICT a = Get<Rom>(src);
+						for (Profile::Board::Roms::iterator b(dst.begin()), end(dst.end()); b != end; ++a, ++b)
 						{
 							b->size = a->size;
 
 							if (full)
 							{
-								b->name = a->name;
-								b->package = a->package;
+								b->name = Get(a->name);
+								b->package = Get(a->package);
 								b->hash = a->hash;
 							}
 
-							b->pins.resize( a->pins.size() );
-
-							Profile::Board::Pins::iterator d(b->pins.begin());
-							for (Rom::Pins::const_iterator c(a->pins.begin()), end(a->pins.end()); c != end; ++c, ++d)
-							{
-								d->number = c->number;
-								d->function = c->function;
-							}
+							Fill( b->pins, *a );
 						}
 					}
 				}
 
 				for (uint j=0; j < 2; ++j)
 				{
-					if (full || (j ? profile.board.GetVram() == GetVramSize() : profile.board.GetWram() == GetWramSize()))
+					if (full || (j ? profile.board.GetVram() == vramSize : profile.board.GetWram() == wramSize))
 					{
-						const Rams& src = (j ? vram : wram);
+						const Table& src = (j ? vram : wram);
 						Profile::Board::Rams& dst = (j ? profile.board.vram : profile.board.wram);
 
-						dst.resize( src.size() );
+						dst.resize( src.count );
 
-						Profile::Board::Rams::iterator b(dst.begin());
-						for (Rams::const_iterator a(src.begin()), end(src.end()); a != end; ++a, ++b)
+						const Ram* NST_RESTRICT a = Get<Ram>(src);
+						for (Profile::Board::Rams::iterator b(dst.begin()), end(dst.end()); b != end; ++a, ++b)
 						{
 							b->id = a->id;
 							b->size = a->size;
 							b->battery = a->battery;
 
 							if (full)
-								b->package = a->package;
-
-							b->pins.resize( a->pins.size() );
+								b->package = Get(a->package);
 
-							Profile::Board::Pins::iterator d(b->pins.begin());
-							for (Ram::Pins::const_iterator c(a->pins.begin()), end(a->pins.end()); c != end; ++c, ++d)
-							{
-								d->number = c->number;
-								d->function = c->function;
-							}
+							Fill( b->pins, *a );
 						}
 					}
 				}
 
-				profile.board.chips.resize( chips.size() );
+				profile.board.chips.resize( chips.count );
 
-				Profile::Board::Chips::iterator b(profile.board.chips.begin());
-				for (Chips::const_iterator a(chips.begin()), end(chips.end()); a != end; ++a, ++b)
+				const Chip* NST_RESTRICT a = Get<Chip>(chips);
+				for (Profile::Board::Chips::iterator b(profile.board.chips.begin()), end(profile.board.chips.end()); b != end; ++a, ++b)
 				{
-					b->type = a->type;
-					b->package = a->package;
+					b->type = Get(a->type);
+					b->package = Get(a->package);
 					b->battery = a->battery;
 
-					b->pins.resize( a->pins.size() );
-
-					Profile::Board::Pins::iterator d(b->pins.begin());
-					for (Chip::Pins::const_iterator c(a->pins.begin()), end(a->pins.end()); c != end; ++c, ++d)
-					{
-						d->number = c->number;
-						d->function = c->function;
-					}
+					Fill( b->pins, *a );
 				}
 			}
 
-		private:
+			struct Less
+			{
+				bool operator () (const Item& a,const Hash& b) const
+				{
+					return a.hash < b;
+				}
+
+				bool operator () (const Hash& a,const Item& b) const
+				{
+					return a < b.hash;
+				}
+
+				bool operator () (const Item& a,const Item& b) const
+				{
+					return a.hash < b.hash;
+				}
+			};
+		};
+
+		class ImageDatabase::Builder
+		{
+		public:
 
-			bool operator == (const Item& item) const
+			struct Pin
 			{
-				return
-				(
-					system == item.system &&
-					mapper == item.mapper &&
-					board == item.board &&
-					solderPads == item.solderPads &&
-					chips.size() == item.chips.size() &&
-					cpu == item.cpu &&
-					ppu == item.ppu &&
-					GetVramSize() == item.GetVramSize() &&
-					GetWramSize() == item.GetWramSize() &&
-					HasVRamBattery() == item.HasVRamBattery() &&
-					HasWRamBattery() == item.HasWRamBattery() &&
-					HasChipBattery() == item.HasChipBattery() &&
-					std::equal( chips.begin(), chips.end(), item.chips.begin() )
-				);
-			}
+				uint number;
+				dword function;
+
+				Pin() {}
+
+				Pin(uint n,dword s)
+				: number(n), function(s) {}
+			};
 
-			bool Add(Item* const item)
+			typedef std::vector<Pin> Pins;
+
+			struct Ic
 			{
-				item->multiRegion = this->multiRegion ||
-				(
-					(
-						this->system == Profile::System::NES_PAL   ||
-						this->system == Profile::System::NES_PAL_A ||
-						this->system == Profile::System::NES_PAL_B ||
-						this->system == Profile::System::DENDY
-					)
-						!=
-					(
-						item->system == Profile::System::NES_PAL   ||
-						item->system == Profile::System::NES_PAL_A ||
-						item->system == Profile::System::NES_PAL_B ||
-						item->system == Profile::System::DENDY
-					)
-				);
+				dword package;
+				Pins pins;
 
-				Item* it = this;
+				Ic() {}
 
-				for (;;)
-				{
-					if (*it == *item)
-						return false;
+				Ic(dword p,const Pins& i)
+				: package(p), pins(i) {}
+			};
 
-					it->multiRegion = item->multiRegion;
+			struct Rom : Ic
+			{
+				dword id;
+				dword name;
+				dword size;
+				Hash hash;
 
-					if (!it->sibling)
-						break;
+				Rom() {}
 
-					it = it->sibling;
-				}
+				Rom(dword i,dword n,dword s,dword e,const Pins& p,const Hash& c)
+				: Ic(e,p), id(i), name(n), size(s), hash(c) {}
+			};
 
-				it->sibling = item;
+			typedef std::vector<Rom> Roms;
 
-				return true;
-			}
+			struct Ram : Ic
+			{
+				dword id;
+				dword size;
+				bool battery;
 
-			void Finalize(wcstring const lut) const
-			{
-				dump.by   << lut;
-				dump.date << lut;
-
-				title         << lut;
-				altTitle      << lut;
-				clss          << lut;
-				subClss       << lut;
-				catalog       << lut;
-				developer     << lut;
-				portDeveloper << lut;
-				publisher     << lut;
-				region        << lut;
-				revision      << lut;
-				pcb           << lut;
-				board         << lut;
-				cic           << lut;
-
-				for (uint i=0; i < 2; ++i)
-				{
-					for (Roms::const_iterator j((i ? chr : prg).begin()), end((i ? chr : prg).end()); j != end; ++j)
-					{
-						j->name << lut;
-						j->package << lut;
+				Ram() {}
 
-						for (Ic::Pins::const_iterator k(j->pins.begin()), end(j->pins.end()); k != end; ++k)
-							k->function << lut;
-					}
+				Ram(dword i,dword s,bool b,dword e,const Pins& p)
+				: Ic(e,p), id(i), size(s), battery(b) {}
+			};
+
+			typedef std::vector<Ram> Rams;
+
+			struct Chip : Ic
+			{
+				dword type;
+				bool battery;
+
+				Chip() {}
+
+				Chip(dword id,bool b,dword e,const Pins& p)
+				: Ic(e,p), type(id), battery(b) {}
+
+				bool operator == (const Chip& chip) const
+				{
+					return type == chip.type;
 				}
 
-				for (uint i=0; i < 2; ++i)
+				bool operator < (const Chip& chip) const
 				{
-					for (Rams::const_iterator j((i ? wram : vram).begin()), end((i ? wram : vram).end()); j != end; ++j)
-						j->package << lut;
+					return type < chip.type;
 				}
+			};
+
+			typedef std::vector<Chip> Chips;
+
+			struct Property
+			{
+				dword name;
+				dword value;
 
-				for (Chips::const_iterator i(chips.begin()), end(chips.end()); i != end; ++i)
+				Property() {}
+
+				Property(dword n,dword v)
+				: name(n), value(v) {}
+			};
+
+			typedef std::vector<Property> Properties;
+
+			struct Item
+			{
+				~Item();
+
+				const Hash hash;
+				Item* sibling;
+				const dword dumpBy;
+				const dword dumpDate;
+				const Profile::Dump::State dumpState;
+				const dword title;
+				const dword altTitle;
+				const dword clss;
+				const dword subClss;
+				const dword catalog;
+				const dword publisher;
+				const dword developer;
+				const dword portDeveloper;
+				const dword region;
+				const dword revision;
+				const dword pcb;
+				const dword board;
+				const dword cic;
+				const Roms prg;
+				const Roms chr;
+				const Rams wram;
+				const Rams vram;
+				Chips chips;
+				const Properties properties;
+				byte peripherals[ImageDatabase::Item::MAX_PERIPHERALS];
+				const word mapper;
+				const byte solderPads;
+				const byte system;
+				const byte cpu;
+				const byte ppu;
+				const byte players;
+				bool multiRegion;
+
+				Item
+				(
+					const Hash& hashIn,
+					dword dumpByIn,
+					dword dumpDateIn,
+					Profile::Dump::State dumpStateIn,
+					dword titleIn,
+					dword altTitleIn,
+					dword clssIn,
+					dword subClssIn,
+					dword catalogIn,
+					dword publisherIn,
+					dword developerIn,
+					dword portDeveloperIn,
+					dword regionIn,
+					const Properties& propertiesIn,
+					dword playersIn,
+					const byte (&e)[ImageDatabase::Item::MAX_PERIPHERALS],
+					Profile::System::Type systemIn,
+					Profile::System::Cpu cpuIn,
+					Profile::System::Ppu ppuIn,
+					dword revisionIn,
+					dword boardIn,
+					dword pcbIn,
+					uint mapperIn,
+					const Roms& prgIn,
+					const Roms& chrIn,
+					const Rams& wramIn,
+					const Rams& vramIn,
+					const Chips& chipsIn,
+					dword cicIn,
+					uint solderPadsIn
+				)
+				:
+				hash          ( hashIn          ),
+				sibling       ( NULL            ),
+				dumpBy        ( dumpByIn        ),
+				dumpDate      ( dumpDateIn      ),
+				dumpState     ( dumpStateIn     ),
+				title         ( titleIn         ),
+				altTitle      ( altTitleIn      ),
+				clss          ( clssIn          ),
+				subClss       ( subClssIn       ),
+				catalog       ( catalogIn       ),
+				publisher     ( publisherIn     ),
+				developer     ( developerIn     ),
+				portDeveloper ( portDeveloperIn ),
+				region        ( regionIn        ),
+				revision      ( revisionIn      ),
+				pcb           ( pcbIn           ),
+				board         ( boardIn         ),
+				cic           ( cicIn           ),
+				prg           ( prgIn           ),
+				chr           ( chrIn           ),
+				wram          ( wramIn          ),
+				vram          ( vramIn          ),
+				chips         ( chipsIn         ),
+				properties    ( propertiesIn    ),
+				mapper        ( mapperIn        ),
+				solderPads    ( solderPadsIn    ),
+				system        ( systemIn        ),
+				cpu           ( cpuIn           ),
+				ppu           ( ppuIn           ),
+				players       ( playersIn       ),
+				multiRegion   ( false           )
 				{
-					i->type << lut;
-					i->package << lut;
+					for (uint i=0; i < ImageDatabase::Item::MAX_PERIPHERALS; ++i)
+						peripherals[i] = e[i];
 
-					for (Ic::Pins::const_iterator j(i->pins.begin()), end(i->pins.end()); j != end; ++j)
-						j->function << lut;
+					std::sort( chips.begin(), chips.end() );
 				}
 
-				for (Properties::const_iterator i(properties.begin()), end(properties.end()); i != end; ++i)
+				template<typename T>
+				static dword GetMemSize(const T& t)
 				{
-					i->name << lut;
-					i->value << lut;
-				}
+					dword size = 0;
 
-				if (sibling)
-					sibling->Finalize( lut );
-			}
+					for (typename T::const_iterator it(t.begin()), end(t.end()); it != end; ++it)
+						size += it->size;
 
-		public:
+					return size;
+				}
 
-			struct Less
-			{
-				bool operator () (const Item* a,const Item* b) const
+				template<typename T>
+				static bool HasBattery(const T& t)
 				{
-					return a->hash < b->hash;
+					for (typename T::const_iterator it(t.begin()), end(t.end()); it != end; ++it)
+					{
+						if (it->battery)
+							return true;
+					}
+
+					return false;
 				}
 
-				bool operator () (const Item* a,const Hash& b) const
+				bool operator == (const Item& item) const
 				{
-					return a->hash < b;
+					return
+					(
+						system == item.system &&
+						mapper == item.mapper &&
+						board == item.board &&
+						solderPads == item.solderPads &&
+						chips.size() == item.chips.size() &&
+						cpu == item.cpu &&
+						ppu == item.ppu &&
+						GetMemSize( vram ) == GetMemSize( item.vram ) &&
+						GetMemSize( wram ) == GetMemSize( item.wram ) &&
+						HasBattery( vram ) == HasBattery( item.vram ) &&
+						HasBattery( wram ) == HasBattery( item.wram ) &&
+						HasBattery( chips ) == HasBattery( item.chips ) &&
+						std::equal( chips.begin(), chips.end(), item.chips.begin() )
+					);
 				}
 
-				bool operator () (const Hash& a,const Item* b) const
+				bool Add(Item* const item)
 				{
-					return a < b->hash;
-				}
-			};
+					item->multiRegion = this->multiRegion ||
+					(
+						(
+							this->system == Profile::System::NES_PAL   ||
+							this->system == Profile::System::NES_PAL_A ||
+							this->system == Profile::System::NES_PAL_B ||
+							this->system == Profile::System::DENDY
+						)
+							!=
+						(
+							item->system == Profile::System::NES_PAL   ||
+							item->system == Profile::System::NES_PAL_A ||
+							item->system == Profile::System::NES_PAL_B ||
+							item->system == Profile::System::DENDY
+						)
+					);
 
-			class Builder
-			{
-			public:
+					Item* it = this;
 
-				~Builder();
+					for (;;)
+					{
+						if (*it == *item)
+							return false;
 
-				dword operator << (wcstring);
-				void operator << (Item*);
+						it->multiRegion = item->multiRegion;
 
-			private:
+						if (!it->sibling)
+							break;
 
-				struct Less
-				{
-					bool operator () (wcstring a,wcstring b) const
-					{
-						return std::wcscmp( a, b ) < 0;
+						it = it->sibling;
 					}
 
-					bool operator () (const Item* a,const Item* b) const
-					{
-						return a->hash < b->hash;
-					}
-				};
+					it->sibling = item;
 
-				typedef std::map<wcstring,dword,Less> StringMap;
-				typedef std::set<Item*,Less> ItemMap;
+					return true;
+				}
+			};
+
+			~Builder();
 
-				dword stringLength;
-				StringMap stringMap;
-				ItemMap itemMap;
+			dword operator << (wcstring);
+			void operator << (Item*);
 
-			public:
+			void Compile(Image&,uint);
+
+		private:
 
-				Builder()
-				: stringLength(0)
+			struct Less
+			{
+				bool operator () (wcstring a,wcstring b) const
 				{
-					(*this) << L"";
+					return std::wcscmp( a, b ) < 0;
 				}
 
-				void Construct(Strings& strings,const Item**& itemsBegin,const Item**& itemsEnd)
+				bool operator () (const Item* a,const Item* b) const
 				{
-					NST_ASSERT( !strings.Size() && itemsBegin == NULL && itemsEnd == NULL );
+					return a->hash < b->hash;
+				}
+			};
 
-					if (const dword size = itemMap.size())
-					{
-						strings.Resize( stringLength );
-						wchar_t* const NST_RESTRICT sdst = strings.Begin();
+			typedef std::map<wcstring,dword,Less> StringMap;
+			typedef std::set<Item*,Less> ItemMap;
 
-						for (StringMap::const_iterator src(stringMap.begin()), end(stringMap.end()); src != end; ++src)
-							std::wcscpy( sdst + src->second, src->first );
+			template<typename T>
+			static T& At(Image& image,dword offset)
+			{
+				return *reinterpret_cast<T*>(image.Begin() + offset);
+			}
 
-						const Item** dst = new const Item* [size];
+			typedef ImageDatabase::Item Record;
 
-						itemsBegin = dst;
-						itemsEnd = dst + size;
+			static dword Allocate(Image&,dword);
 
-						for (ItemMap::const_iterator src(itemMap.begin()), end(itemMap.end()); src != end; ++src, ++dst)
-						{
-							(*src)->Finalize( sdst );
-							*dst = *src;
-						}
+			void Compile(Image&,dword,const Item&,dword) const;
+			Record::Table Compile(Image&,const Pins&) const;
+			Record::Table Compile(Image&,const Roms&) const;
+			Record::Table Compile(Image&,const Rams&) const;
+			Record::Table Compile(Image&,const Chips&) const;
+			Record::Table Compile(Image&,const Properties&) const;
 
-						itemMap.clear();
-					}
-				}
-			};
+			dword stringLength;
+			dword stringOffset;
+			StringMap stringMap;
+			ItemMap itemMap;
+
+			Record::String GetString(dword id) const
+			{
+				return stringOffset + id * sizeof(wchar_t);
+			}
+
+		public:
+
+			Builder()
+			: stringLength(0), stringOffset(0)
+			{
+				(*this) << L"";
+			}
+
+			dword NumItems() const
+			{
+				return itemMap.size();
+			}
 		};
 
 		ImageDatabase::ImageDatabase()
-		: enabled(true)
+		: enabled(true), header(NULL)
 		{
 			items.begin = NULL;
 			items.end = NULL;
@@ -1022,11 +1178,11 @@ namespace Nes
 					( items.hashing & HASHING_CRC  ) ? hash.GetCrc32() : 0UL
 				);
 
-				const Item** item = std::lower_bound( items.begin, items.end, searchHash, Item::Less() );
+				const Item* item = std::lower_bound( items.begin, items.end, searchHash, Item::Less() );
 
-				if (item != items.end && (*item)->GetHash() == searchHash)
+				if (item != items.end && item->GetHash() == searchHash)
 				{
-					for (const Item* it = *item; it; it = it->GetNextSibling())
+					for (const Item* it = item; it; it = it->GetNextSibling())
 					{
 						switch (it->GetSystem())
 						{
@@ -1062,7 +1218,7 @@ namespace Nes
 						}
 					}
 
-					return *item;
+					return item;
 				}
 			}
 
@@ -1175,14 +1331,53 @@ namespace Nes
 				item->Fill( profile, full );
 		}
 
+		bool ImageDatabase::IsCompiled(std::istream& stream)
+		{
+			byte id[4];
+			Stream::In( &stream ).Peek( id, 4 );
+
+			return std::memcmp( id, Header::magic, 4 ) == 0;
+		}
+
 		Result ImageDatabase::Load(std::istream& baseStream,std::istream* overrideStream)
 		{
 			Unload();
 
 			try
 			{
+				if (IsCompiled( baseStream ))
+				{
+					if (overrideStream)
+						return RESULT_ERR_UNSUPPORTED;
+
+					Stream::In stream( &baseStream );
+
+					Header compiled;
+					stream.Peek( reinterpret_cast<byte*>(&compiled), sizeof(compiled) );
+
+					if (compiled.order != Header::ENDIAN || compiled.size < sizeof(compiled))
+						return RESULT_ERR_INVALID_FILE;
+
+					image.Resize( compiled.size );
+					stream.Read( image.Begin(), image.Size() );
+
+					const Result result = Map( image.Begin(), image.Size() );
+
+					if (NES_FAILED(result))
+					{
+						Unload( true );
+						return result;
+					}
+
+					Log() << "Database: "
+						<< (items.end - items.begin)
+						<< " items mapped from compiled DB" NST_LINEBREAK;
+
+					return RESULT_OK;
+				}
+
 				Xml baseXml, overrideXml;
-				Item::Builder builder;
+				Builder builder;
 
 				for (uint multi=0; multi < (overrideStream ? 2 : 1); ++multi)
 				{
@@ -1442,7 +1637,7 @@ namespace Nes
 									);
 								}
 
-								Item::Properties properties;
+								Builder::Properties properties;
 
 								if (Xml::Node node=image.GetChild( L"properties" ))
 								{
@@ -1450,7 +1645,7 @@ namespace Nes
 									{
 										properties.push_back
 										(
-											Item::Property
+											Builder::Property
 											(
 												builder << node.GetAttribute(L"name").GetValue(),
 												builder << node.GetAttribute(L"value").GetValue()
@@ -1459,9 +1654,9 @@ namespace Nes
 									}
 								}
 
-								Item::Roms prg, chr;
-								Item::Rams wram, vram;
-								Item::Chips chips;
+								Builder::Roms prg, chr;
+								Builder::Rams wram, vram;
+								Builder::Chips chips;
 
 								for (Xml::Node node=board.GetFirstChild(); node; node=node.GetNextSibling())
 								{
@@ -1482,7 +1677,7 @@ namespace Nes
 										}
 									}
 
-									Item::Ic::Pins pins;
+									Builder::Pins pins;
 
 									for (Xml::Node child(node.GetFirstChild()); child; child=child.GetNextSibling())
 									{
@@ -1492,7 +1687,7 @@ namespace Nes
 											wcstring const function = child.GetAttribute(L"function").GetValue();
 
 											if (number >= MIN_IC_PINS && number <= MAX_IC_PINS && *function)
-												pins.push_back( Item::Ic::Pin(number,builder << function) );
+												pins.push_back( Builder::Pin(number,builder << function) );
 										}
 									}
 
@@ -1504,7 +1699,7 @@ namespace Nes
 										{
 											(first ? prg : chr).push_back
 											(
-												Item::Rom
+												Builder::Rom
 												(
 													node.GetAttribute( L"id" ).GetUnsignedValue(),
 													builder << node.GetAttribute( L"name" ).GetValue(),
@@ -1522,7 +1717,7 @@ namespace Nes
 										{
 											(first ? wram : vram).push_back
 											(
-												Item::Ram
+												Builder::Ram
 												(
 													node.GetAttribute( L"id" ).GetUnsignedValue(),
 													size,
@@ -1537,7 +1732,7 @@ namespace Nes
 									{
 										chips.push_back
 										(
-											Item::Chip
+											Builder::Chip
 											(
 												builder << node.GetAttribute( L"type" ).GetValue(),
 												node.GetAttribute( L"battery" ).IsValue( L"1" ),
@@ -1548,7 +1743,7 @@ namespace Nes
 									}
 								}
 
-								builder << new Item
+								builder << new Builder::Item
 								(
 									hash,
 									builder << image.GetAttribute( L"dumper" ).GetValue(),
@@ -1586,7 +1781,10 @@ namespace Nes
 					}
 				}
 
-				builder.Construct( strings, items.begin, items.end );
+				builder.Compile( image, items.hashing );
+
+				if (NES_FAILED(Map( image.Begin(), image.Size() )))
+					throw RESULT_ERR_GENERIC;
 			}
 			catch (Result result)
 			{
@@ -1605,45 +1803,123 @@ namespace Nes
 			}
 
 			Log() << "Database: "
-                  << (items.end - items.begin)
-                  << " items imported from "
-                  << (overrideStream ? "internal & external" : "internal")
-                  <<  " DB" NST_LINEBREAK;
+				<< (items.end - items.begin)
+				<< " items imported from "
+				<< (overrideStream ? "internal & external" : "internal")
+				<< " DB" NST_LINEBREAK;
 
 			return RESULT_OK;
 		}
 
-		void ImageDatabase::Unload(const bool error)
+		Result ImageDatabase::Load(const void* data,dword size)
 		{
-			if (const Item** it=items.begin)
+			Unload();
+
+			const Result result = Map( static_cast<const byte*>(data), size );
+
+			if (NES_SUCCEEDED(result))
 			{
-				do
-				{
-					delete *it;
-				}
-				while (++it != items.end);
+				Log() << "Database: "
+					<< (items.end - items.begin)
+					<< " items mapped from compiled DB" NST_LINEBREAK;
+			}
+
+			return result;
+		}
+
+		Result ImageDatabase::Map(const byte* const data,const dword size)
+		{
+			NST_ASSERT( !header );
 
-				delete [] items.begin;
+			if (!data || size < sizeof(Header) || reinterpret_cast<std::size_t>(data) % sizeof(dword))
+				return RESULT_ERR_INVALID_PARAM;
 
-				items.begin = NULL;
-				items.end = NULL;
+			const Header& compiled = *reinterpret_cast<const Header*>(data);
+
+			if (std::memcmp( compiled.id, Header::magic, sizeof(compiled.id) ) || compiled.order != Header::ENDIAN)
+				return RESULT_ERR_INVALID_FILE;
+
+			if (compiled.version != Header::VERSION || compiled.charSize != sizeof(wchar_t) || compiled.itemSize != sizeof(Item))
+				return RESULT_ERR_UNSUPPORTED_FILE_VERSION;
+
+			if
+			(
+				compiled.size != size ||
+				compiled.hashing > (HASHING_SHA1|HASHING_CRC) ||
+				compiled.items > compiled.records ||
+				compiled.records > (size - sizeof(Header)) / sizeof(Item) ||
+				compiled.strings < sizeof(wchar_t) ||
+				compiled.strings % sizeof(dword) ||
+				compiled.strings > size - sizeof(Header) - compiled.records * sizeof(Item)
+			)
+				return RESULT_ERR_CORRUPT_FILE;
+
+			const dword strings = sizeof(Header) + compiled.records * sizeof(Item);
+
+			// the string area ends with a terminator or its zero padding,
+			// so any string starting inside it is terminated inside it too
+
+			if (*reinterpret_cast<const wchar_t*>(data + strings + compiled.strings - sizeof(wchar_t)))
+				return RESULT_ERR_CORRUPT_FILE;
+
+			const Item* const records = reinterpret_cast<const Item*>(data + sizeof(Header));
+
+			for (dword i=0; i < compiled.records; ++i)
+			{
+				if (!records[i].IsValid( sizeof(Header) + i * sizeof(Item), compiled ))
+					return RESULT_ERR_CORRUPT_FILE;
+			}
+
+			header = &compiled;
+
+			items.begin = reinterpret_cast<const Item*>(data + sizeof(Header));
+			items.end = items.begin + compiled.items;
+			items.hashing = compiled.hashing;
+
+			return RESULT_OK;
+		}
+
+		Result ImageDatabase::Export(std::ostream& stream) const
+		{
+			if (!header)
+				return RESULT_ERR_NOT_READY;
+
+			try
+			{
+				Stream::Out( &stream ).Write( reinterpret_cast<const byte*>(header), header->size );
+			}
+			catch (Result result)
+			{
+				return result;
+			}
+			catch (...)
+			{
+				return RESULT_ERR_GENERIC;
 			}
 
+			return RESULT_OK;
+		}
+
+		void ImageDatabase::Unload(const bool error)
+		{
+			items.begin = NULL;
+			items.end = NULL;
 			items.hashing = HASHING_DETECT;
 
-			strings.Destroy();
+			header = NULL;
+			image.Destroy();
 
 			if (error)
 				Log::Flush( "Database: error, aborting.." NST_LINEBREAK );
 		}
 
-		ImageDatabase::Item::Builder::~Builder()
+		ImageDatabase::Builder::~Builder()
 		{
 			for (ItemMap::const_iterator it(itemMap.begin()), end(itemMap.end()); it != end; ++it)
 				delete *it;
 		}
 
-		dword ImageDatabase::Item::Builder::operator << (wcstring string)
+		dword ImageDatabase::Builder::operator << (wcstring string)
 		{
 			const std::pair<StringMap::iterator,bool> entry
 			(
@@ -1656,7 +1932,7 @@ namespace Nes
 			return entry.first->second;
 		}
 
-		void ImageDatabase::Item::Builder::operator << (Item* item)
+		void ImageDatabase::Builder::operator << (Item* item)
 		{
 			std::pair<ItemMap::iterator,bool> entry;
 
@@ -1674,7 +1950,242 @@ namespace Nes
 				delete item;
 		}
 
-		ImageDatabase::Item::~Item()
+		dword ImageDatabase::Builder::Allocate(Image& image,const dword length)
+		{
+			const dword offset = image.Size();
+
+			if (image.Capacity() < offset + length)
+				image.Reserve( (offset + length) * 2 );
+
+			image.Resize( offset + length );
+			std::memset( image.Begin() + offset, 0, length );
+
+			return offset;
+		}
+
+		void ImageDatabase::Builder::Compile(Image& image,const uint hashing)
+		{
+			NST_ASSERT( !image.Size() );
+
+			dword records = 0;
+
+			for (ItemMap::const_iterator it(itemMap.begin()), end(itemMap.end()); it != end; ++it)
+			{
+				for (const Item* item = *it; item; item = item->sibling)
+					++records;
+			}
+
+			Allocate( image, sizeof(Header) + records * sizeof(Record) );
+
+			// strings go first so that every table written below can refer to them
+
+			const dword strings = (stringLength * sizeof(wchar_t) + (sizeof(dword)-1)) & ~dword(sizeof(dword)-1);
+			stringOffset = Allocate( image, strings );
+
+			for (StringMap::const_iterator it(stringMap.begin()), end(stringMap.end()); it != end; ++it)
+				std::wcscpy( reinterpret_cast<wchar_t*>(image.Begin() + GetString(it->second)), it->first );
+
+			// hash-sorted head records first, their siblings after them
+
+			dword head = sizeof(Header);
+			dword tail = sizeof(Header) + itemMap.size() * sizeof(Record);
+
+			for (ItemMap::const_iterator it(itemMap.begin()), end(itemMap.end()); it != end; ++it)
+			{
+				dword offset = head;
+				head += sizeof(Record);
+
+				for (const Item* item = *it; item; item = item->sibling)
+				{
+					const dword sibling = (item->sibling ? tail : 0);
+
+					Compile( image, offset, *item, sibling );
+
+					offset = tail;
+					tail += (sibling ? sizeof(Record) : 0);
+				}
+			}
+
+			NST_ASSERT( tail == sizeof(Header) + records * sizeof(Record) );
+
+			Header& compiled = At<Header>( image, 0 );
+
+			std::memcpy( compiled.id, Header::magic, sizeof(compiled.id) );
+
+			compiled.order = Header::ENDIAN;
+			compiled.version = Header::VERSION;
+			compiled.charSize = sizeof(wchar_t);
+			compiled.itemSize = sizeof(Record);
+			compiled.hashing = hashing;
+			compiled.size = image.Size();
+			compiled.items = itemMap.size();
+			compiled.records = records;
+			compiled.strings = strings;
+
+			image.Defrag();
+		}
+
+		void ImageDatabase::Builder::Compile(Image& image,const dword offset,const Item& src,const dword sibling) const
+		{
+			const Record::Table prg        ( Compile( image, src.prg        ) );
+			const Record::Table chr        ( Compile( image, src.chr        ) );
+			const Record::Table wram       ( Compile( image, src.wram       ) );
+			const Record::Table vram       ( Compile( image, src.vram       ) );
+			const Record::Table chips      ( Compile( image, src.chips      ) );
+			const Record::Table properties ( Compile( image, src.properties ) );
+
+			Record& dst = At<Record>( image, offset );
+
+			dst.hash          = src.hash;
+			dst.offset        = offset;
+			dst.sibling       = sibling;
+			dst.dumpBy        = GetString( src.dumpBy        );
+			dst.dumpDate      = GetString( src.dumpDate      );
+			dst.title         = GetString( src.title         );
+			dst.altTitle      = GetString( src.altTitle      );
+			dst.clss          = GetString( src.clss          );
+			dst.subClss       = GetString( src.subClss       );
+			dst.catalog       = GetString( src.catalog       );
+			dst.publisher     = GetString( src.publisher     );
+			dst.developer     = GetString( src.developer     );
+			dst.portDeveloper = GetString( src.portDeveloper );
+			dst.region        = GetString( src.region        );
+			dst.revision      = GetString( src.revision      );
+			dst.pcb           = GetString( src.pcb           );
+			dst.board         = GetString( src.board         );
+			dst.cic           = GetString( src.cic           );
+			dst.prg           = prg;
+			dst.chr           = chr;
+			dst.wram          = wram;
+			dst.vram          = vram;
+			dst.chips         = chips;
+			dst.properties    = properties;
+			dst.prgSize       = Item::GetMemSize( src.prg  );
+			dst.chrSize       = Item::GetMemSize( src.chr  );
+			dst.wramSize      = Item::GetMemSize( src.wram );
+			dst.vramSize      = Item::GetMemSize( src.vram );
+			dst.mapper        = src.mapper;
+			dst.solderPads    = src.solderPads;
+			dst.system        = src.system;
+			dst.cpu           = src.cpu;
+			dst.ppu           = src.ppu;
+			dst.players       = src.players;
+			dst.dump          = src.dumpState;
+			dst.flags         =
+			(
+				( src.multiRegion                 ? Record::MULTI_REGION : 0U ) |
+				( Item::HasBattery( src.wram  )   ? Record::WRAM_BATTERY : 0U ) |
+				( Item::HasBattery( src.vram  )   ? Record::VRAM_BATTERY : 0U ) |
+				( Item::HasBattery( src.chips )   ? Record::CHIP_BATTERY : 0U )
+			);
+
+			for (uint i=0; i < Record::MAX_PERIPHERALS; ++i)
+				dst.peripherals[i] = src.peripherals[i];
+		}
+
+		ImageDatabase::Builder::Record::Table ImageDatabase::Builder::Compile(Image& image,const Pins& src) const
+		{
+			Record::Table table;
+
+			table.count = src.size();
+			table.offset = (table.count ? Allocate( image, table.count * sizeof(Record::Pin) ) : 0);
+
+			for (dword i=0; i < table.count; ++i)
+			{
+				Record::Pin& dst = At<Record::Pin>( image, table.offset + i * sizeof(Record::Pin) );
+
+				dst.number = src[i].number;
+				dst.function = GetString( src[i].function );
+			}
+
+			return table;
+		}
+
+		ImageDatabase::Builder::Record::Table ImageDatabase::Builder::Compile(Image& image,const Roms& src) const
+		{
+			Record::Table table;
+
+			table.count = src.size();
+			table.offset = (table.count ? Allocate( image, table.count * sizeof(Record::Rom) ) : 0);
+
+			for (dword i=0; i < table.count; ++i)
+			{
+				const Record::Table pins( Compile( image, src[i].pins ) );
+				Record::Rom& dst = At<Record::Rom>( image, table.offset + i * sizeof(Record::Rom) );
+
+				dst.id = src[i].id;
+				dst.name = GetString( src[i].name );
+				dst.package = GetString( src[i].package );
+				dst.size = src[i].size;
+				dst.hash = src[i].hash;
+				dst.pins = pins;
+			}
+
+			return table;
+		}
+
+		ImageDatabase::Builder::Record::Table ImageDatabase::Builder::Compile(Image& image,const Rams& src) const
+		{
+			Record::Table table;
+
+			table.count = src.size();
+			table.offset = (table.count ? Allocate( image, table.count * sizeof(Record::Ram) ) : 0);
+
+			for (dword i=0; i < table.count; ++i)
+			{
+				const Record::Table pins( Compile( image, src[i].pins ) );
+				Record::Ram& dst = At<Record::Ram>( image, table.offset + i * sizeof(Record::Ram) );
+
+				dst.id = src[i].id;
+				dst.size = src[i].size;
+				dst.battery = src[i].battery;
+				dst.package = GetString( src[i].package );
+				dst.pins = pins;
+			}
+
+			return table;
+		}
+
+		ImageDatabase::Builder::Record::Table ImageDatabase::Builder::Compile(Image& image,const Chips& src) const
+		{
+			Record::Table table;
+
+			table.count = src.size();
+			table.offset = (table.count ? Allocate( image, table.count * sizeof(Record::Chip) ) : 0);
+
+			for (dword i=0; i < table.count; ++i)
+			{
+				const Record::Table pins( Compile( image, src[i].pins ) );
+				Record::Chip& dst = At<Record::Chip>( image, table.offset + i * sizeof(Record::Chip) );
+
+				dst.type = GetString( src[i].type );
+				dst.package = GetString( src[i].package );
+				dst.battery = src[i].battery;
+				dst.pins = pins;
+			}
+
+			return table;
+		}
+
+		ImageDatabase::Builder::Record::Table ImageDatabase::Builder::Compile(Image& image,const Properties& src) const
+		{
+			Record::Table table;
+
+			table.count = src.size();
+			table.offset = (table.count ? Allocate( image, table.count * sizeof(Record::Property) ) : 0);
+
+			for (dword i=0; i < table.count; ++i)
+			{
+				Record::Property& dst = At<Record::Property>( image, table.offset + i * sizeof(Record::Property) );
+
+				dst.name = GetString( src[i].name );
+				dst.value = GetString( src[i].value );
+			}
+
+			return table;
+		}
+
+		ImageDatabase::Builder::Item::~Item()
 		{
 			if (const Item* item=sibling)
 			{
@@ -38,7 +38,9 @@ namespace Nes
 	{
 		class ImageDatabase
 		{
+			struct Header;
 			class Item;
+			class Builder;
 
 		public:
 
@@ -104,9 +106,12 @@ namespace Nes
 		private:
 
 			Result Load(std::istream&,std::istream*);
+			Result Map(const byte*,dword);
 			void Unload(bool);
 
-			typedef Vector<wchar_t> Strings;
+			static bool IsCompiled(std::istream&);
+
+			typedef Vector<byte> Image;
 
 			enum
 			{
@@ -126,12 +131,13 @@ namespace Nes
 
 			struct
 			{
-				const Item** begin;
-				const Item** end;
+				const Item* begin;
+				const Item* end;
 				uint hashing;
 			}   items;
 
-			Strings strings;
+			const Header* header;
+			Image image;
 
 		public:
 
@@ -145,6 +151,9 @@ namespace Nes
 				return Load( baseStream, &overrideStream );
 			}
 
+			Result Load(const void*,dword);
+			Result Export(std::ostream&) const;
+
 			void Unload()
 			{
 				Unload( false );
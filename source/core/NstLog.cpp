@@ -42,7 +42,7 @@ namespace Nes
 			std::string string;
 		};
 
-		bool Log::enabled = true;
+		NST_THREAD_LOCAL bool Log::enabled = true;
 
 		Log::Log()
 		: object( !Api::User::logCallback ? NULL : new (std::nothrow) Object )
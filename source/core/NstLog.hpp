@@ -80,7 +80,7 @@ namespace Nes
 			struct Object;
 			Object* const object;
 
-			static bool enabled;
+			static NST_THREAD_LOCAL bool enabled;
 
 		public:
 
@@ -91,6 +91,8 @@ namespace Nes
 			Log& operator << (int    i) { return operator << ( long  (i) ); }
 			Log& operator << (uint   i) { return operator << ( ulong (i) ); }
 
+			// silences logging on the calling thread only
+
 			class Suppressor
 			{
 				const bool state;
@@ -25,6 +25,7 @@
 #include "NstMachine.hpp"
 #include "NstCartridge.hpp"
 #include "NstCheats.hpp"
+#include "NstRamSearch.hpp"
 #include "NstNsf.hpp"
 #include "NstImageDatabase.hpp"
 #include "input/NstInpDevice.hpp"
@@ -45,10 +46,12 @@ namespace Nes
 		:
 		state         (Api::Machine::NTSC),
 		frame         (0),
-		extPort       (new Input::AdapterTwo( *new Input::Pad(cpu,0), *new Input::Pad(cpu,1) )),
+		mic           (0),
+		extPort       (new Input::AdapterTwo( *new Input::Pad(cpu,0,mic), *new Input::Pad(cpu,1,mic) )),
 		expPort       (new Input::Device( cpu )),
 		image         (NULL),
 		cheats        (NULL),
+		ramSearch     (NULL),
 		imageDatabase (NULL),
 		ppu           (cpu)
 		{
@@ -148,6 +151,9 @@ namespace Nes
 			Image::Unload( image );
 			image = NULL;
 
+			delete ramSearch;
+			ramSearch = NULL;
+
 			state &= (Api::Machine::NTSC|Api::Machine::PAL);
 
 			Api::Machine::eventCallback( Api::Machine::EVENT_UNLOAD, result );
@@ -236,6 +242,7 @@ namespace Nes
 		{
 			if (state & Api::Machine::ON)
 			{
+				renderer.Flush();
 				tracker.PowerOff();
 
 				if (image && !image->PowerOff() && NES_SUCCEEDED(result))
@@ -485,53 +492,131 @@ namespace Nes
 		#pragma optimize("", on)
 		#endif
 
-		void Machine::Execute
+		inline void Machine::ExecuteFrame
 		(
 			Video::Output* const video,
 			Sound::Output* const sound,
-			Input::Controllers* const input
+			Input::Controllers* const input,
+			const bool frameLock
 		)
 		{
-			NST_ASSERT( state & Api::Machine::ON );
+			if (state & Api::Machine::CARTRIDGE)
+				static_cast<Cartridge*>(image)->BeginFrame( Api::Input(*this), input );
 
-			if (!(state & Api::Machine::SOUND))
-			{
-				if (state & Api::Machine::CARTRIDGE)
-					static_cast<Cartridge*>(image)->BeginFrame( Api::Input(*this), input );
+			extPort->BeginFrame( input );
+			expPort->BeginFrame( input );
 
-				extPort->BeginFrame( input );
-				expPort->BeginFrame( input );
+			ppu.BeginFrame( frameLock );
 
-				ppu.BeginFrame( tracker.IsFrameLocked() );
-
-				if (cheats)
-					cheats->BeginFrame( tracker.IsFrameLocked() );
+			if (cheats)
+			{
+				NST_PROFILE_SCOPE( STAGE_CHEATS );
+				cheats->BeginFrame( frameLock );
+			}
 
+			{
+				NST_PROFILE_SCOPE( STAGE_CPU );
 				cpu.ExecuteFrame( sound );
-				ppu.EndFrame();
+			}
+
+			ppu.EndFrame();
 
-				if (video)
-					renderer.Blit( *video, ppu.GetScreen(), ppu.GetBurstPhase() );
+			if (video)
+			{
+				NST_PROFILE_SCOPE( STAGE_VIDEO );
+				renderer.Present( *video, ppu.GetScreen(), ppu.GetBurstPhase() );
+			}
 
+			{
+				NST_PROFILE_SCOPE( STAGE_CPU );
 				cpu.EndFrame();
+			}
 
-				if (image)
-					image->VSync();
+			if (ramSearch && !frameLock && !tracker.IsRunningAhead())
+				ramSearch->EndFrame();
 
-				extPort->EndFrame();
-				expPort->EndFrame();
+			if (image)
+				image->VSync();
+
+			extPort->EndFrame();
+			expPort->EndFrame();
+
+			frame++;
+		}
+
+		inline void Machine::ExecuteSoundFrame(Sound::Output* const sound)
+		{
+			static_cast<Nsf*>(image)->BeginFrame();
 
-				frame++;
+			{
+				NST_PROFILE_SCOPE( STAGE_CPU );
+				cpu.ExecuteFrame( sound );
+				cpu.EndFrame();
 			}
+
+			image->VSync();
+		}
+
+		void Machine::Execute
+		(
+			Video::Output* const video,
+			Sound::Output* const sound,
+			Input::Controllers* const input
+		)
+		{
+			NST_ASSERT( state & Api::Machine::ON );
+
+		#ifdef NST_PROFILE
+			profiler.Begin();
+		#endif
+
+			if (!(state & Api::Machine::SOUND))
+				ExecuteFrame( video, sound, input, tracker.IsFrameLocked() );
 			else
+				ExecuteSoundFrame( sound );
+
+		#ifdef NST_PROFILE
+			profiler.End( 1 );
+		#endif
+		}
+
+		dword Machine::ExecuteFrames(const dword count,const bool stopOnJam,Input::Controllers* input)
+		{
+			NST_ASSERT( (state & Api::Machine::ON) && count );
+
+			dword executed = 0;
+
+		#ifdef NST_PROFILE
+			profiler.Begin();
+		#endif
+
+			if (!(state & Api::Machine::SOUND))
 			{
-				static_cast<Nsf*>(image)->BeginFrame();
+				const bool frameLock = tracker.IsFrameLocked();
 
-				cpu.ExecuteFrame( sound );
-				cpu.EndFrame();
+				do
+				{
+					ExecuteFrame( NULL, NULL, input, frameLock );
 
-				image->VSync();
+					if (input)
+						++input;
+				}
+				while (++executed != count && !(stopOnJam && cpu.IsJammed()));
 			}
+			else
+			{
+				do
+				{
+					ExecuteSoundFrame( NULL );
+				}
+				while (++executed != count && !(stopOnJam && cpu.IsJammed()));
+			}
+
+		#ifdef NST_PROFILE
+			profiler.End( executed );
+		#endif
+
+			return executed;
 		}
 
 		NES_POKE_D(Machine,4016)
@@ -29,6 +29,7 @@
 #include "NstCpu.hpp"
 #include "NstPpu.hpp"
 #include "NstTracker.hpp"
+#include "NstProfiler.hpp"
 #include "NstVideoRenderer.hpp"
 
 #ifdef NST_PRAGMA_ONCE
@@ -58,6 +59,7 @@ namespace Nes
 
 		class Image;
 		class Cheats;
+		class RamSearch;
 		class ImageDatabase;
 
 		class Machine
@@ -74,6 +76,8 @@ namespace Nes
 				Input::Controllers*
 			);
 
+			dword ExecuteFrames(dword,bool,Input::Controllers*);
+
 			enum ColorMode
 			{
 				COLORMODE_YUV,
@@ -104,6 +108,8 @@ namespace Nes
 
 		private:
 
+			void ExecuteFrame(Video::Output*,Sound::Output*,Input::Controllers*,bool);
+			void ExecuteSoundFrame(Sound::Output*);
 			void UpdateModels();
 			Result UpdateVideo(PpuModel,ColorMode);
 			ColorMode GetColorMode() const;
@@ -123,15 +129,20 @@ namespace Nes
 
 		public:
 
+			uint mic;
 			Input::Adapter* extPort;
 			Input::Device* expPort;
 			Image* image;
 			Cheats* cheats;
+			RamSearch* ramSearch;
 			ImageDatabase* imageDatabase;
 			Tracker tracker;
 			Cpu cpu;
 			Ppu ppu;
 			Video::Renderer renderer;
+		#ifdef NST_PROFILE
+			Profiler profiler;
+		#endif
 
 			uint Is(uint a) const
 			{
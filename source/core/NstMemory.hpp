@@ -26,6 +26,7 @@
 #define NST_MEMORY_H
 
 #include "NstRam.hpp"
+#include "NstProfiler.hpp"
 
 #ifdef NST_PRAGMA_ONCE
 #pragma once
@@ -276,6 +277,11 @@ namespace Nes
 				return pages.mem[page];
 			}
 
+			const byte* const* Slot(uint page) const
+			{
+				return pages.mem + page;
+			}
+
 			void Poke(uint address,uint data)
 			{
 				const uint page = address >> MEM_PAGE_SHIFT;
@@ -470,6 +476,8 @@ namespace Nes
 		{
 			NST_COMPILE_ASSERT( (SPACE >= ADDRESS + SIZE) && SIZE && (SIZE % MEM_PAGE_SIZE == 0) );
 
+			NST_PROFILE_COUNT( BANK_SWAPS );
+
 			enum
 			{
 				MEM_OFFSET = ValueBits<SIZE>::VALUE-1,
@@ -492,6 +500,8 @@ namespace Nes
 			NST_COMPILE_ASSERT( SIZE && (SIZE % MEM_PAGE_SIZE == 0) );
 			NST_ASSERT( SPACE >= address + SIZE );
 
+			NST_PROFILE_COUNT( BANK_SWAPS );
+
 			enum
 			{
 				MEM_OFFSET = ValueBits<SIZE>::VALUE-1,
@@ -513,6 +523,8 @@ namespace Nes
 		{
 			NST_COMPILE_ASSERT( (SPACE >= ADDRESS + SIZE * 2) && SIZE && (SIZE % MEM_PAGE_SIZE == 0) );
 
+			NST_PROFILE_COUNT( BANK_SWAPS );
+
 			enum
 			{
 				MEM_OFFSET = ValueBits<SIZE>::VALUE-1,
@@ -535,6 +547,8 @@ namespace Nes
 		{
 			NST_COMPILE_ASSERT( (SPACE >= ADDRESS + SIZE * 4) && SIZE && (SIZE % MEM_PAGE_SIZE == 0) );
 
+			NST_PROFILE_COUNT( BANK_SWAPS );
+
 			enum
 			{
 				MEM_OFFSET = ValueBits<SIZE>::VALUE-1,
@@ -559,6 +573,8 @@ namespace Nes
 		{
 			NST_COMPILE_ASSERT( (SPACE >= ADDRESS + SIZE * 4) && SIZE && (SIZE % MEM_PAGE_SIZE == 0) );
 
+			NST_PROFILE_COUNT( BANK_SWAPS );
+
 			enum
 			{
 				MEM_OFFSET = ValueBits<SIZE>::VALUE-1,
@@ -588,6 +604,8 @@ namespace Nes
 			NST_COMPILE_ASSERT( SIZE && (SIZE % MEM_PAGE_SIZE == 0) );
 			NST_ASSERT( SPACE >= address + SIZE * 2 );
 
+			NST_PROFILE_COUNT( BANK_SWAPS );
+
 			enum
 			{
 				MEM_OFFSET = ValueBits<SIZE>::VALUE-1,
@@ -611,6 +629,8 @@ namespace Nes
 			NST_COMPILE_ASSERT( SIZE && (SIZE % MEM_PAGE_SIZE == 0) );
 			NST_ASSERT( SPACE >= address + SIZE * 4 );
 
+			NST_PROFILE_COUNT( BANK_SWAPS );
+
 			enum
 			{
 				MEM_OFFSET = ValueBits<SIZE>::VALUE-1,
@@ -636,6 +656,8 @@ namespace Nes
 			NST_COMPILE_ASSERT( SIZE && (SIZE % MEM_PAGE_SIZE == 0) );
 			NST_ASSERT( SPACE >= address + SIZE * 4 );
 
+			NST_PROFILE_COUNT( BANK_SWAPS );
+
 			enum
 			{
 				MEM_OFFSET = ValueBits<SIZE>::VALUE-1,
@@ -664,6 +686,8 @@ namespace Nes
 		{
 			NST_COMPILE_ASSERT( (SPACE >= ADDRESS + SIZE) && SIZE && (SIZE % MEM_PAGE_SIZE == 0) );
 
+			NST_PROFILE_COUNT( BANK_SWAPS );
+
 			enum
 			{
 				MEM_OFFSET = ValueBits<SIZE>::VALUE-1,
@@ -688,6 +712,8 @@ namespace Nes
 			NST_COMPILE_ASSERT( SIZE && (SIZE % MEM_PAGE_SIZE == 0) );
 			NST_ASSERT( SPACE >= address + SIZE );
 
+			NST_PROFILE_COUNT( BANK_SWAPS );
+
 			enum
 			{
 				MEM_OFFSET = ValueBits<SIZE>::VALUE-1,
@@ -763,7 +789,7 @@ namespace Nes
 				for (uint i=0; i < MEM_NUM_PAGES; ++i)
 				{
 					if (pageData[i*3+0] < NUM_SOURCES)
-						Source( pageData[i*3+0] ).SwapBank<MEM_PAGE_SIZE>( i * MEM_PAGE_SIZE, pageData[i*3+1] | uint(pageData[i*3+2]) << 8 );
+						Source( pageData[i*3+0] ).template SwapBank<MEM_PAGE_SIZE>( i * MEM_PAGE_SIZE, pageData[i*3+1] | uint(pageData[i*3+2]) << 8 );
 					else
 						throw RESULT_ERR_CORRUPT_FILE;
 				}
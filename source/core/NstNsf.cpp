@@ -102,6 +102,7 @@ namespace Nes
 				using Boards::Konami::Vrc7::Sound::Reset;
 				using Boards::Konami::Vrc7::Sound::UpdateSettings;
 				using Boards::Konami::Vrc7::Sound::GetSample;
+				using Boards::Konami::Vrc7::Sound::Prepare;
 			};
 
 			struct S5b : Boards::Sunsoft::S5b::Sound
@@ -134,6 +135,7 @@ namespace Nes
 			bool UpdateSettings();
 			Sample GetSample();
 			Cycle Clock(Cycle,Cycle,Cycle);
+			void Prepare(uint);
 
 			Clocks clocks;
 
@@ -421,6 +423,10 @@ namespace Nes
 			cpu.Map( 0x38FE ).Set( this, &Nsf::Peek_38FE, &Nsf::Poke_Nop );
 			cpu.Map( 0x38FF ).Set( this, &Nsf::Peek_38FF, &Nsf::Poke_Nop );
 
+			// the player parks on a jmp to itself between calls
+
+			cpu.SetIdleRange( 0x38FD, 0x38FF );
+
 			cpu.Map( 0x4017 ).Set( this, &Nsf::Peek_Nop, &Nsf::Poke_4017 );
 
 			const bool fds = chips && chips->fds;
@@ -694,6 +700,12 @@ namespace Nes
 			);
 		}
 
+		void Nsf::Chips::Prepare(const uint length)
+		{
+			if (vrc7)
+				vrc7->Prepare( length );
+		}
+
 		inline uint Nsf::FetchLast(uint offset) const
 		{
 			NST_ASSERT( offset <= 0xFFF );
@@ -25,6 +25,7 @@
 #include <cstring>
 #include "NstCpu.hpp"
 #include "NstPpu.hpp"
+#include "NstProfiler.hpp"
 #include "NstState.hpp"
 
 namespace Nes
@@ -266,6 +267,7 @@ namespace Nes
 			oam.phase = &Ppu::EvaluateSpritesPhase0;
 			oam.buffered = oam.buffer;
 			oam.visible = oam.output;
+			oam.lineDirty = true;
 			oam.mask = 0;
 
 			output.target = NULL;
@@ -1393,6 +1395,7 @@ namespace Nes
 				);
 
 				Oam::Output* const NST_RESTRICT entry = oam.visible++;
+				oam.lineDirty = true;
 
 				entry->pixels[( a^=6 )] = ( p       ) & 0x3;
 				entry->pixels[( a^=2 )] = ( p >>= 2 ) & 0x3;
@@ -1433,29 +1436,53 @@ namespace Nes
 			while (buffer != oam.buffered);
 		}
 
-		NST_FORCE_INLINE void Ppu::RenderPixel()
+		void Ppu::LoadSpriteLine()
 		{
-			uint clock;
-			uint pixel = tiles.pixels[((clock=cycles.hClock++) + scroll.xFine) & 15] & tiles.mask;
+			oam.lineDirty = false;
+			std::memset( oam.line, 0, sizeof(oam.line) );
 
-			for (const Oam::Output* NST_RESTRICT sprite=oam.output, *const end=oam.visible; sprite != end; ++sprite)
+			for (const Oam::Output* NST_RESTRICT sprite=oam.visible; sprite != oam.output; )
 			{
-				uint x = clock - sprite->x;
+				--sprite;
 
-				if (x > 7)
-					continue;
+				const uint attribute =
+				(
+					sprite->palette |
+					(sprite->behind ? Oam::LINE_BEHIND : 0U) |
+					(sprite->zero ? Oam::LINE_ZERO : 0U)
+				);
 
-				x = sprite->pixels[x] & oam.mask;
+				byte* const NST_RESTRICT line = oam.line + sprite->x;
 
-				if (x)
+				for (uint i=0; i < 8; ++i)
 				{
-					if (pixel & sprite->zero)
-						regs.status |= Regs::STATUS_SP_ZERO_HIT;
+					if (const uint pixel = sprite->pixels[i])
+						line[i] = attribute + pixel;
+				}
+			}
+		}
+
+		NST_FORCE_INLINE void Ppu::RenderPixel()
+		{
+			uint clock;
+			uint pixel = tiles.pixels[((clock=cycles.hClock++) + scroll.xFine) & 15] & tiles.mask;
 
-					if (!(pixel & sprite->behind))
-						pixel = sprite->palette + x;
+			if (oam.lineDirty)
+				LoadSpriteLine();
 
-					break;
+			if (const uint sprite = oam.line[clock] & oam.mask)
+			{
+				if (!(pixel & 0x3))
+				{
+					pixel = sprite & Oam::LINE_PIXEL;
+				}
+				else
+				{
+					if (sprite & Oam::LINE_ZERO)
+						regs.status |= Regs::STATUS_SP_ZERO_HIT;
+
+					if (!(sprite & Oam::LINE_BEHIND))
+						pixel = sprite & Oam::LINE_PIXEL;
 				}
 			}
 
@@ -1468,22 +1495,13 @@ namespace Nes
 			cycles.hClock = 256;
 			uint pixel = tiles.pixels[(255 + scroll.xFine) & 15] & tiles.mask;
 
-			for (const Oam::Output* NST_RESTRICT sprite=oam.output, *const end=oam.visible; sprite != end; ++sprite)
-			{
-				uint x = 255U - sprite->x;
-
-				if (x > 7)
-					continue;
+			if (oam.lineDirty)
+				LoadSpriteLine();
 
-				x = sprite->pixels[x] & oam.mask;
-
-				if (x)
-				{
-					if (!(pixel & sprite->behind))
-						pixel = sprite->palette + x;
-
-					break;
-				}
+			if (const uint sprite = oam.line[255] & oam.mask)
+			{
+				if (!(pixel & 0x3) || !(sprite & Oam::LINE_BEHIND))
+					pixel = sprite & Oam::LINE_PIXEL;
 			}
 
 			Video::Screen::Pixel* const NST_RESTRICT target = output.target++;
@@ -1494,6 +1512,9 @@ namespace Nes
 		{
 			NST_VERIFY( cycles.count != cycles.hClock );
 
+			NST_PROFILE_SCOPE( STAGE_PPU );
+			NST_PROFILE_COUNT( PPU_SYNCS );
+
 			if (regs.ctrl[1] & Regs::CTRL1_BG_SP_ENABLED)
 			{
 				switch (cycles.hClock)
@@ -1865,6 +1886,7 @@ namespace Nes
 
 						scroll.ResetX();
 						oam.visible = oam.output;
+						oam.lineDirty = true;
 						cycles.hClock = 258;
 
 						if (cycles.count <= 258)
@@ -2193,6 +2215,7 @@ namespace Nes
 
 						regs.status = (regs.status & 0xFF) | (regs.status >> 1 & Regs::STATUS_VBLANK);
 						oam.visible = oam.output;
+						oam.lineDirty = true;
 						cycles.hClock = HCLOCK_VBLANK_2;
 
 						if (cycles.count <= HCLOCK_VBLANK_2)
@@ -2765,6 +2788,7 @@ namespace Nes
 							hBlankHook.Execute();
 
 						oam.visible = oam.output;
+						oam.lineDirty = true;
 						cycles.hClock = 258;
 
 						if (cycles.count <= 258)
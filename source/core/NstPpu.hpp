@@ -216,6 +216,7 @@ namespace Nes
 			NST_FORCE_INLINE  void LoadSprite(uint,uint,const byte* NST_RESTRICT);
 			NST_SINGLE_CALL void PreLoadTiles();
 			NST_SINGLE_CALL void LoadTiles();
+			NST_NO_INLINE void LoadSpriteLine();
 			NST_FORCE_INLINE void RenderPixel();
 			NST_SINGLE_CALL void RenderPixel255();
 			NST_NO_INLINE void Run();
@@ -335,7 +336,10 @@ namespace Nes
 					Y_FLIP           = 0x80,
 					XFINE            = 0x07,
 					RANGE_MSB        = 0x08,
-					TILE_LSB         = 0x01
+					TILE_LSB         = 0x01,
+					LINE_PIXEL       = 0x1F,
+					LINE_BEHIND      = 0x20,
+					LINE_ZERO        = 0x40
 				};
 
 				struct Output
@@ -361,11 +365,13 @@ namespace Nes
 				byte show[2];
 				bool spriteZeroInLine;
 				bool spriteLimit;
+				bool lineDirty;
 
 				byte ram[0x100];
 				byte buffer[MAX_LINE_SPRITES*4];
 
 				Output output[MAX_LINE_SPRITES];
+				byte line[256+8];
 			};
 
 			struct NameTable
@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "NstAssert.hpp"
+
+#ifdef NST_PROFILE
+
+#include <cstring>
+#include "NstProfiler.hpp"
+
+#ifdef NST_WIN32
+
+ #ifndef WIN32_LEAN_AND_MEAN
+ #define WIN32_LEAN_AND_MEAN
+ #endif
+
+ #include <windows.h>
+
+#else
+
+ #include <time.h>
+
+#endif
+
+namespace Nes
+{
+	namespace Core
+	{
+		NST_THREAD_LOCAL Profiler::Thread Profiler::thread;
+
+		#ifdef NST_MSVC_OPTIMIZE
+		#pragma optimize("s", on)
+		#endif
+
+		Profiler::Profiler()
+		{
+			Reset();
+		}
+
+		void Profiler::Reset()
+		{
+			std::memset( &start, 0, sizeof(start) );
+			std::memset( &last, 0, sizeof(last) );
+			std::memset( &total, 0, sizeof(total) );
+			frames = 0;
+		}
+
+		qword Profiler::Frequency()
+		{
+		#ifdef NST_WIN32
+			LARGE_INTEGER frequency;
+			::QueryPerformanceFrequency( &frequency );
+			return frequency.QuadPart;
+		#else
+			return 1000000000;
+		#endif
+		}
+
+		#ifdef NST_MSVC_OPTIMIZE
+		#pragma optimize("", on)
+		#endif
+
+		qword Profiler::Ticks()
+		{
+		#ifdef NST_WIN32
+			LARGE_INTEGER counter;
+			::QueryPerformanceCounter( &counter );
+			return counter.QuadPart;
+		#else
+			timespec time;
+			::clock_gettime( CLOCK_MONOTONIC, &time );
+			return qword(time.tv_sec) * 1000000000 + time.tv_nsec;
+		#endif
+		}
+
+		void Profiler::Switch(const uint stage)
+		{
+			const qword now = Ticks();
+
+			thread.ticks[thread.stage] += now - thread.mark;
+			thread.mark = now;
+			thread.stage = stage;
+		}
+
+		void Profiler::Read(Sample& sample)
+		{
+			Switch( thread.stage );
+
+			for (uint i=0; i < NUM_COUNTERS; ++i)
+				sample.counters[i] = thread.counters[i];
+
+			for (uint i=0; i < NUM_STAGES; ++i)
+				sample.ticks[i] = thread.ticks[i];
+		}
+
+		void Profiler::Begin()
+		{
+			NST_ASSERT( thread.stage == STAGE_OTHER );
+
+			Read( start );
+		}
+
+		void Profiler::End(const dword count)
+		{
+			NST_ASSERT( count && thread.stage == STAGE_OTHER );
+
+			Sample sample;
+			Read( sample );
+
+			for (uint i=0; i < NUM_COUNTERS; ++i)
+			{
+				const qword delta = sample.counters[i] - start.counters[i];
+				last.counters[i] = delta / count;
+				total.counters[i] += delta;
+			}
+
+			for (uint i=0; i < NUM_STAGES; ++i)
+			{
+				const qword delta = sample.ticks[i] - start.ticks[i];
+				last.ticks[i] = delta / count;
+				total.ticks[i] += delta;
+			}
+
+			frames += count;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,165 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NST_PROFILER_H
+#define NST_PROFILER_H
+
+#ifdef NST_PRAGMA_ONCE
+#pragma once
+#endif
+
+#ifdef NST_PROFILE
+
+#ifndef NST_NATIVE_QWORD
+#error NST_PROFILE requires a native 64 bit integer type!
+#endif
+
+namespace Nes
+{
+	namespace Core
+	{
+		class Profiler
+		{
+		public:
+
+			Profiler();
+
+			enum Counter
+			{
+				INSTRUCTIONS,
+				PPU_SYNCS,
+				APU_SAMPLES,
+				HOOKS,
+				BANK_SWAPS,
+				NUM_COUNTERS
+			};
+
+			enum Stage
+			{
+				STAGE_OTHER,
+				STAGE_CPU,
+				STAGE_PPU,
+				STAGE_APU,
+				STAGE_HOOKS,
+				STAGE_CHEATS,
+				STAGE_VIDEO,
+				NUM_STAGES
+			};
+
+			struct Sample
+			{
+				qword counters[NUM_COUNTERS];
+				qword ticks[NUM_STAGES];
+			};
+
+			class Scope
+			{
+				const uint previous;
+
+			public:
+
+				explicit Scope(Stage stage)
+				: previous(thread.stage)
+				{
+					Switch( stage );
+				}
+
+				~Scope()
+				{
+					Switch( previous );
+				}
+			};
+
+			static void Count(Counter counter)
+			{
+				++thread.counters[counter];
+			}
+
+			static void Count(Counter counter,dword n)
+			{
+				thread.counters[counter] += n;
+			}
+
+			void Reset();
+			void Begin();
+			void End(dword);
+
+			static qword Frequency();
+
+		private:
+
+			friend class Scope;
+
+			static void Switch(uint);
+			static void Read(Sample&);
+			static qword Ticks();
+
+			struct Thread
+			{
+				qword counters[NUM_COUNTERS];
+				qword ticks[NUM_STAGES];
+				qword mark;
+				uint stage;
+			};
+
+			static NST_THREAD_LOCAL Thread thread;
+
+			Sample start;
+			Sample last;
+			Sample total;
+			qword frames;
+
+		public:
+
+			const Sample& GetLast() const
+			{
+				return last;
+			}
+
+			const Sample& GetTotal() const
+			{
+				return total;
+			}
+
+			qword NumFrames() const
+			{
+				return frames;
+			}
+		};
+	}
+}
+
+#define NST_PROFILE_COUNT(counter_) Nes::Core::Profiler::Count( Nes::Core::Profiler::counter_ )
+#define NST_PROFILE_COUNT_N(counter_,n_) Nes::Core::Profiler::Count( Nes::Core::Profiler::counter_, n_ )
+#define NST_PROFILE_SCOPE(stage_) const Nes::Core::Profiler::Scope profileScope( Nes::Core::Profiler::stage_ )
+
+#else
+
+#define NST_PROFILE_COUNT(counter_)
+#define NST_PROFILE_COUNT_N(counter_,n_)
+#define NST_PROFILE_SCOPE(stage_)
+
+#endif
+
+#endif
@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include "NstCpu.hpp"
+#include "NstRamSearch.hpp"
+
+#ifdef NST_MM_INTRINSICS
+#include <emmintrin.h>
+#endif
+
+namespace Nes
+{
+	namespace Core
+	{
+		#ifdef NST_MSVC_OPTIMIZE
+		#pragma optimize("s", on)
+		#endif
+
+		RamSearch::RamSearch(const Cpu& c,const bool w)
+		:
+		cpu         (c),
+		wram        (w),
+		frameFilter (FILTER_NONE),
+		frameValue  (0),
+		latest      (0),
+		count       (w ? SIZE : RAM_SIZE)
+		{
+			std::memset( candidates, 0xFF, RAM_SIZE );
+			std::memset( candidates + RAM_SIZE, wram ? 0xFF : 0x00, WRAM_SIZE );
+
+			Snapshot( snapshots[0] );
+			std::memcpy( snapshots[1], snapshots[0], SIZE );
+		}
+
+		void RamSearch::SetFrameFilter(const Filter filter,const uint value)
+		{
+			frameFilter = filter;
+			frameValue = value;
+		}
+
+		#ifdef NST_MSVC_OPTIMIZE
+		#pragma optimize("", on)
+		#endif
+
+		void RamSearch::Snapshot(byte* const NST_RESTRICT dst) const
+		{
+			std::memcpy( dst, cpu.GetRam(), RAM_SIZE );
+
+			if (wram)
+			{
+				// through the CPU map, cheat patches and board read handlers included
+				for (uint i=0; i < WRAM_SIZE; ++i)
+					dst[RAM_SIZE+i] = cpu.Peek( WRAM_BEGIN + i );
+			}
+			else
+			{
+				std::memset( dst + RAM_SIZE, 0x00, WRAM_SIZE );
+			}
+		}
+
+		void RamSearch::Apply(const Filter filter,const uint value)
+		{
+			latest ^= 1;
+			Snapshot( snapshots[latest] );
+
+			const byte* const NST_RESTRICT current = snapshots[latest];
+			const byte* const NST_RESTRICT previous = snapshots[latest^1];
+
+			byte* const NST_RESTRICT mask = candidates;
+			const uint size = (wram ? SIZE : RAM_SIZE);
+
+		#ifdef NST_MM_INTRINSICS
+
+			NST_COMPILE_ASSERT( SIZE % 16 == 0 && RAM_SIZE % 16 == 0 );
+
+			const __m128i bias = _mm_set1_epi8( char(0x80) );
+			const __m128i constant = _mm_set1_epi8( char(value) );
+			const __m128i ones = _mm_set1_epi8( 1 );
+
+			__m128i sum = _mm_setzero_si128();
+
+			for (uint i=0; i < size; i += 16)
+			{
+				const __m128i c = _mm_loadu_si128( reinterpret_cast<const __m128i*>(current + i) );
+				const __m128i p = _mm_loadu_si128( reinterpret_cast<const __m128i*>(previous + i) );
+
+				__m128i m = _mm_loadu_si128( reinterpret_cast<const __m128i*>(mask + i) );
+
+				switch (filter)
+				{
+					case FILTER_EQUAL:     m = _mm_and_si128( m, _mm_cmpeq_epi8( c, constant ) ); break;
+					case FILTER_NOT_EQUAL: m = _mm_andnot_si128( _mm_cmpeq_epi8( c, constant ), m ); break;
+					case FILTER_CHANGED:   m = _mm_andnot_si128( _mm_cmpeq_epi8( c, p ), m ); break;
+					case FILTER_UNCHANGED: m = _mm_and_si128( m, _mm_cmpeq_epi8( c, p ) ); break;
+					case FILTER_INCREASED: m = _mm_and_si128( m, _mm_cmpgt_epi8( _mm_xor_si128( c, bias ), _mm_xor_si128( p, bias ) ) ); break;
+					case FILTER_DECREASED: m = _mm_and_si128( m, _mm_cmpgt_epi8( _mm_xor_si128( p, bias ), _mm_xor_si128( c, bias ) ) ); break;
+					case FILTER_NONE: break;
+				}
+
+				_mm_storeu_si128( reinterpret_cast<__m128i*>(mask + i), m );
+				sum = _mm_add_epi64( sum, _mm_sad_epu8( _mm_and_si128( m, ones ), _mm_setzero_si128() ) );
+			}
+
+			count = dword(_mm_cvtsi128_si32( sum )) + dword(_mm_cvtsi128_si32( _mm_srli_si128( sum, 8 ) ));
+
+		#else
+
+			dword n = 0;
+
+			for (uint i=0; i < size; ++i)
+			{
+				bool match;
+
+				switch (filter)
+				{
+					case FILTER_EQUAL:     match = (current[i] == value);       break;
+					case FILTER_NOT_EQUAL: match = (current[i] != value);       break;
+					case FILTER_CHANGED:   match = (current[i] != previous[i]); break;
+					case FILTER_UNCHANGED: match = (current[i] == previous[i]); break;
+					case FILTER_INCREASED: match = (current[i] >  previous[i]); break;
+					case FILTER_DECREASED: match = (current[i] <  previous[i]); break;
+					default:               match = true;                        break;
+				}
+
+				mask[i] &= (match ? 0xFF : 0x00);
+				n += mask[i] & 0x1;
+			}
+
+			count = n;
+
+		#endif
+		}
+	}
+}
@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NST_RAMSEARCH_H
+#define NST_RAMSEARCH_H
+
+#ifdef NST_PRAGMA_ONCE
+#pragma once
+#endif
+
+namespace Nes
+{
+	namespace Core
+	{
+		class RamSearch
+		{
+		public:
+
+			RamSearch(const Cpu&,bool);
+
+			enum Filter
+			{
+				FILTER_NONE,
+				FILTER_EQUAL,
+				FILTER_NOT_EQUAL,
+				FILTER_CHANGED,
+				FILTER_UNCHANGED,
+				FILTER_INCREASED,
+				FILTER_DECREASED
+			};
+
+			void Apply(Filter,uint);
+			void SetFrameFilter(Filter,uint);
+
+		private:
+
+			enum
+			{
+				RAM_SIZE = 0x800,
+				WRAM_BEGIN = 0x6000,
+				WRAM_SIZE = SIZE_8K,
+				SIZE = RAM_SIZE + WRAM_SIZE
+			};
+
+			void Snapshot(byte*) const;
+
+			const Cpu& cpu;
+			const bool wram;
+			byte frameFilter;
+			byte frameValue;
+			uint latest;
+			dword count;
+			byte candidates[SIZE];
+			byte snapshots[2][SIZE];
+
+		public:
+
+			void EndFrame()
+			{
+				if (frameFilter != FILTER_NONE)
+					Apply( static_cast<Filter>(frameFilter), frameValue );
+			}
+
+			dword NumMatches() const
+			{
+				return count;
+			}
+
+			template<typename T>
+			dword GetMatches(T* matches,const dword length) const
+			{
+				dword n = 0;
+
+				for (uint i=0; i < SIZE && n < length; ++i)
+				{
+					if (candidates[i])
+					{
+						matches[n].address = (i < RAM_SIZE ? i : WRAM_BEGIN + (i - RAM_SIZE));
+						matches[n].value = snapshots[latest][i];
+						matches[n].previous = snapshots[latest^1][i];
+						++n;
+					}
+				}
+
+				return n;
+			}
+		};
+	}
+}
+
+#endif
@@ -42,10 +42,8 @@ namespace Nes
 			#endif
 
 			Saver::Saver(StdStream p,bool c,bool i,dword append)
-			: stream(p), chunks(CHUNK_RESERVE), useCompression(c), internal(i)
+			: stream(p), useCompression(c), internal(i)
 			{
-				NST_COMPILE_ASSERT( CHUNK_RESERVE >= 2 );
-
 				chunks.SetTo(1);
 				chunks.Front() = 0;
 
@@ -57,6 +55,13 @@ namespace Nes
 				}
 			}
 
+			Saver::Saver(byte* mem,dword size,bool i)
+			: stream(mem,size), useCompression(false), internal(i)
+			{
+				chunks.SetTo(1);
+				chunks.Front() = 0;
+			}
+
 			Saver::~Saver()
 			{
 				NST_VERIFY( chunks.Size() == 1 );
@@ -153,7 +158,13 @@ namespace Nes
 			#endif
 
 			Loader::Loader(StdStream p,bool c)
-			: stream(p), chunks(CHUNK_RESERVE), checkCrc(c)
+			: stream(p), checkCrc(c)
+			{
+				chunks.SetTo(0);
+			}
+
+			Loader::Loader(const byte* mem,dword size,bool c)
+			: stream(mem,size), checkCrc(c)
 			{
 				chunks.SetTo(0);
 			}
@@ -41,11 +41,85 @@ namespace Nes
 	{
 		namespace State
 		{
+			class Chunks
+			{
+			public:
+
+				Chunks()
+				: size(0) {}
+
+				void SetTo(uint count)
+				{
+					NST_ASSERT( count <= MAX_DEPTH );
+					size = count;
+				}
+
+				void Append(dword length)
+				{
+					if (size == MAX_DEPTH)
+						throw RESULT_ERR_CORRUPT_FILE;
+
+					data[size++] = length;
+				}
+
+				dword Pop()
+				{
+					NST_ASSERT( size );
+					return data[--size];
+				}
+
+				dword& operator [] (uint i)
+				{
+					NST_ASSERT( i < size );
+					return data[i];
+				}
+
+				dword& Front()
+				{
+					NST_ASSERT( size );
+					return data[0];
+				}
+
+				dword Front() const
+				{
+					NST_ASSERT( size );
+					return data[0];
+				}
+
+				dword& Back()
+				{
+					NST_ASSERT( size );
+					return data[size-1];
+				}
+
+				dword Back() const
+				{
+					NST_ASSERT( size );
+					return data[size-1];
+				}
+
+				uint Size() const
+				{
+					return size;
+				}
+
+			private:
+
+				enum
+				{
+					MAX_DEPTH = 16
+				};
+
+				uint size;
+				dword data[MAX_DEPTH];
+			};
+
 			class Saver
 			{
 			public:
 
 				Saver(StdStream,bool,bool,dword=0);
+				Saver(byte*,dword,bool=false);
 				~Saver();
 
 				Saver& Begin(dword);
@@ -63,12 +137,7 @@ namespace Nes
 
 			private:
 
-				enum
-				{
-					CHUNK_RESERVE = 8
-				};
-
-				Vector<dword> chunks;
+				Chunks chunks;
 				const bool useCompression;
 				const bool internal;
 
@@ -92,6 +161,11 @@ namespace Nes
 				{
 					return internal;
 				}
+
+				dword Size() const
+				{
+					return chunks.Front();
+				}
 			};
 
 			class Loader
@@ -99,6 +173,7 @@ namespace Nes
 			public:
 
 				Loader(StdStream,bool);
+				Loader(const byte*,dword,bool);
 				~Loader();
 
 				dword Begin();
@@ -148,12 +223,7 @@ namespace Nes
 
 				void CheckRead(dword);
 
-				enum
-				{
-					CHUNK_RESERVE = 8
-				};
-
-				Vector<dword> chunks;
+				Chunks chunks;
 				const bool checkCrc;
 
 			public:
@@ -22,6 +22,7 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////
 
+#include <cstring>
 #include <iostream>
 #include "NstVector.hpp"
 #include "NstStream.hpp"
@@ -40,19 +41,44 @@ namespace Nes
 					ref.clear();
 			}
 
-			void In::SafeRead(byte* data,dword size)
+			dword In::SafeRead(byte* data,dword length)
 			{
-				static_cast<std::istream*>(stream)->read( reinterpret_cast<char*>(data), size );
+				if (!stream)
+				{
+					if (length > size - offset)
+						length = size - offset;
+
+					std::memcpy( data, memory + offset, length );
+					offset += length;
+
+					return length;
+				}
+
+				std::istream& ref = *static_cast<std::istream*>(stream);
+				ref.read( reinterpret_cast<char*>(data), length );
+
+				return ref.gcount();
 			}
 
-			void In::Read(byte* data,dword size)
+			void In::Read(byte* data,dword length)
 			{
-				NST_ASSERT( data && size );
+				NST_ASSERT( data && length );
+
+				if (stream)
+				{
+					SafeRead( data, length );
 
-				SafeRead( data, size );
+					if (!*static_cast<std::istream*>(stream))
+						throw RESULT_ERR_CORRUPT_FILE;
+				}
+				else
+				{
+					if (size - offset < length)
+						throw RESULT_ERR_CORRUPT_FILE;
 
-				if (!*static_cast<std::istream*>(stream))
-					throw RESULT_ERR_CORRUPT_FILE;
+					std::memcpy( data, memory + offset, length );
+					offset += length;
+				}
 			}
 
 			uint In::Read8()
@@ -90,6 +116,9 @@ namespace Nes
 
 			uint In::SafeRead8()
 			{
+				if (!stream)
+					return offset < size ? memory[offset++] : ~0U;
+
 				byte data;
 				SafeRead( &data, 1 );
 				return *static_cast<std::istream*>(stream) ? data : ~0U;
@@ -101,6 +130,15 @@ namespace Nes
 
 			void In::Seek(idword distance)
 			{
+				if (!stream)
+				{
+					if (distance < 0 ? dword(-distance) > offset : dword(distance) > size - offset)
+						throw RESULT_ERR_CORRUPT_FILE;
+
+					offset += distance;
+					return;
+				}
+
 				Clear();
 
 				if (!static_cast<std::istream*>(stream)->seekg( distance, std::ios::cur ))
@@ -109,6 +147,9 @@ namespace Nes
 
 			ulong In::Length()
 			{
+				if (!stream)
+					return size - offset;
+
 				Clear();
 
 				std::istream& ref = *static_cast<std::istream*>(stream);
@@ -225,13 +266,13 @@ namespace Nes
 				return length;
 			}
 
-			void In::Read(char* dst,dword size)
+			void In::Read(char* dst,dword length)
 			{
-				NST_ASSERT( dst && size );
+				NST_ASSERT( dst && length );
 
-				Vector<byte> buffer( size );
-				Read( buffer.Begin(), size );
-				AsciiToC( dst, buffer.Begin(), size );
+				Vector<byte> buffer( length );
+				Read( buffer.Begin(), length );
+				AsciiToC( dst, buffer.Begin(), length );
 			}
 
 			dword In::Read(Vector<char>& string)
@@ -281,16 +322,32 @@ namespace Nes
 
 			bool In::Eof()
 			{
+				if (!stream)
+					return offset == size;
+
 				std::istream& ref = *static_cast<std::istream*>(stream);
 				return ref.eof() || (ref.peek(), ref.eof());
 			}
 
-			void Out::Write(const byte* data,dword size)
+			void Out::Write(const byte* data,dword length)
 			{
-				NST_VERIFY( data && size );
+				NST_VERIFY( data && length );
 
-				if (!static_cast<std::ostream*>(stream)->write( reinterpret_cast<const char*>(data), size ))
-					throw RESULT_ERR_CORRUPT_FILE;
+				if (stream)
+				{
+					if (!static_cast<std::ostream*>(stream)->write( reinterpret_cast<const char*>(data), length ))
+						throw RESULT_ERR_CORRUPT_FILE;
+				}
+				else
+				{
+					if (size - offset < length)
+						throw RESULT_ERR_OUT_OF_MEMORY;
+
+					if (memory)
+						std::memcpy( memory + offset, data, length );
+
+					offset += length;
+				}
 			}
 
 			void Out::Write8(const uint data)
@@ -360,6 +417,15 @@ namespace Nes
 
 			void Out::Seek(idword distance)
 			{
+				if (!stream)
+				{
+					if (distance < 0 ? dword(-distance) > offset : dword(distance) > size - offset)
+						throw RESULT_ERR_CORRUPT_FILE;
+
+					offset += distance;
+					return;
+				}
+
 				Clear();
 
 				if (!static_cast<std::ostream*>(stream)->seekp( distance, std::ios::cur ))
@@ -368,6 +434,9 @@ namespace Nes
 
 			bool Out::SeekEnd()
 			{
+				if (!stream)
+					return false;
+
 				Clear();
 
 				std::ostream& ref = *static_cast<std::ostream*>(stream);
@@ -47,18 +47,26 @@ namespace Nes
 			class In
 			{
 				StdStream const stream;
+				const byte* const memory;
+				dword offset;
+				const dword size;
 
-				void SafeRead(byte*,dword);
 				void Clear();
 
 			public:
 
 				explicit In(StdStream s)
-				: stream(s)
+				: stream(s), memory(NULL), offset(0), size(0)
 				{
 					NST_ASSERT( stream );
 				}
 
+				In(const byte* m,dword n)
+				: stream(NULL), memory(m), offset(0), size(n)
+				{
+					NST_ASSERT( memory );
+				}
+
 				static dword AsciiToC(char* NST_RESTRICT,const byte* NST_RESTRICT,dword);
 
 				void  Read(byte*,dword);
@@ -69,6 +77,7 @@ namespace Nes
 				dword Read32();
 				qword Read64();
 				uint  SafeRead8();
+				dword SafeRead(byte*,dword);
 				void  Peek(byte*,dword);
 				uint  Peek8();
 				uint  Peek16();
@@ -98,17 +107,23 @@ namespace Nes
 			class Out
 			{
 				StdStream const stream;
+				byte* const memory;
+				dword offset;
+				const dword size;
 
 				void Clear();
 
 			public:
 
 				explicit Out(StdStream s)
-				: stream(s)
+				: stream(s), memory(NULL), offset(0), size(0)
 				{
 					NST_ASSERT( stream );
 				}
 
+				Out(byte* m,dword n)
+				: stream(NULL), memory(m), offset(0), size(n) {}
+
 				void Write(const byte*,dword);
 				void Write8(uint);
 				void Write16(uint);
@@ -0,0 +1,459 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <new>
+#include <climits>
+#include "NstAssert.hpp"
+#include "NstThreadPool.hpp"
+
+#ifndef NST_NO_THREADS
+
+ #ifdef NST_WIN32
+
+  #ifndef WIN32_LEAN_AND_MEAN
+  #define WIN32_LEAN_AND_MEAN
+  #endif
+
+  #include <windows.h>
+  #include <process.h>
+
+ #else
+
+  #include <pthread.h>
+  #include <unistd.h>
+  #include <sys/time.h>
+
+ #endif
+
+#else
+
+ #include <ctime>
+
+#endif
+
+namespace Nes
+{
+	namespace Core
+	{
+		#ifdef NST_MSVC_OPTIMIZE
+		#pragma optimize("s", on)
+		#endif
+
+	#ifndef NST_NO_THREADS
+
+		class ThreadPool::Mutex
+		{
+		public:
+
+			Mutex()
+			{
+			#ifdef NST_WIN32
+				::InitializeCriticalSection( &section );
+			#else
+				if (::pthread_mutex_init( &mutex, NULL ))
+					throw RESULT_ERR_GENERIC;
+			#endif
+			}
+
+			~Mutex()
+			{
+			#ifdef NST_WIN32
+				::DeleteCriticalSection( &section );
+			#else
+				::pthread_mutex_destroy( &mutex );
+			#endif
+			}
+
+			void Lock()
+			{
+			#ifdef NST_WIN32
+				::EnterCriticalSection( &section );
+			#else
+				::pthread_mutex_lock( &mutex );
+			#endif
+			}
+
+			void Unlock()
+			{
+			#ifdef NST_WIN32
+				::LeaveCriticalSection( &section );
+			#else
+				::pthread_mutex_unlock( &mutex );
+			#endif
+			}
+
+		private:
+
+		#ifdef NST_WIN32
+			CRITICAL_SECTION section;
+		#else
+			pthread_mutex_t mutex;
+		#endif
+		};
+
+		class ThreadPool::Semaphore
+		{
+		public:
+
+			Semaphore()
+			{
+			#ifdef NST_WIN32
+
+				handle = ::CreateSemaphore( NULL, 0, LONG_MAX, NULL );
+
+				if (!handle)
+					throw RESULT_ERR_GENERIC;
+
+			#else
+
+				count = 0;
+
+				if (::pthread_mutex_init( &mutex, NULL ))
+					throw RESULT_ERR_GENERIC;
+
+				if (::pthread_cond_init( &cond, NULL ))
+				{
+					::pthread_mutex_destroy( &mutex );
+					throw RESULT_ERR_GENERIC;
+				}
+
+			#endif
+			}
+
+			~Semaphore()
+			{
+			#ifdef NST_WIN32
+				::CloseHandle( handle );
+			#else
+				::pthread_cond_destroy( &cond );
+				::pthread_mutex_destroy( &mutex );
+			#endif
+			}
+
+			void Post(uint n=1)
+			{
+			#ifdef NST_WIN32
+				::ReleaseSemaphore( handle, n, NULL );
+			#else
+				::pthread_mutex_lock( &mutex );
+				count += n;
+				::pthread_mutex_unlock( &mutex );
+
+				if (n > 1)
+					::pthread_cond_broadcast( &cond );
+				else
+					::pthread_cond_signal( &cond );
+			#endif
+			}
+
+			void Wait()
+			{
+			#ifdef NST_WIN32
+				::WaitForSingleObject( handle, INFINITE );
+			#else
+				::pthread_mutex_lock( &mutex );
+
+				while (!count)
+					::pthread_cond_wait( &cond, &mutex );
+
+				--count;
+				::pthread_mutex_unlock( &mutex );
+			#endif
+			}
+
+		private:
+
+		#ifdef NST_WIN32
+			HANDLE handle;
+		#else
+			pthread_mutex_t mutex;
+			pthread_cond_t cond;
+			uint count;
+		#endif
+		};
+
+		struct ThreadPool::Shared
+		{
+			Shared();
+
+			bool Execute();
+
+		#ifdef NST_WIN32
+			static unsigned __stdcall Entry(void*);
+			HANDLE handles[MAX_THREADS];
+		#else
+			static void* Entry(void*);
+			pthread_t handles[MAX_THREADS];
+		#endif
+
+			Mutex mutex;
+			Semaphore start;
+			Semaphore done;
+			Job* job;
+			uint parts;
+			uint next;
+			bool exit;
+		};
+
+		ThreadPool::Shared::Shared()
+		:
+		job   (NULL),
+		parts (0),
+		next  (0),
+		exit  (false)
+		{
+		}
+
+		bool ThreadPool::Shared::Execute()
+		{
+			mutex.Lock();
+
+			Job* const current = job;
+			const uint part = next;
+			const bool pending = (part < parts);
+
+			if (pending)
+				next++;
+
+			mutex.Unlock();
+
+			if (pending)
+			{
+				current->Execute( part );
+				done.Post();
+			}
+
+			return pending;
+		}
+
+		#ifdef NST_WIN32
+		unsigned __stdcall ThreadPool::Shared::Entry(void* data)
+		#else
+		void* ThreadPool::Shared::Entry(void* data)
+		#endif
+		{
+			Shared& shared = *static_cast<Shared*>(data);
+
+			for (;;)
+			{
+				shared.start.Wait();
+
+				shared.mutex.Lock();
+				const bool exit = shared.exit;
+				shared.mutex.Unlock();
+
+				if (exit)
+					break;
+
+				while (shared.Execute());
+			}
+
+			return 0;
+		}
+
+	#endif
+
+		ThreadPool::ThreadPool()
+		:
+		shared  (NULL),
+		job     (NULL),
+		parts   (0),
+		threads (0)
+		{
+		}
+
+		ThreadPool::~ThreadPool()
+		{
+			Destroy();
+		}
+
+		void ThreadPool::Destroy()
+		{
+		#ifndef NST_NO_THREADS
+
+			if (shared)
+			{
+				shared->mutex.Lock();
+				shared->exit = true;
+				shared->mutex.Unlock();
+
+				shared->start.Post( threads );
+
+				for (uint i=0; i < threads; ++i)
+				{
+				#ifdef NST_WIN32
+					::WaitForSingleObject( shared->handles[i], INFINITE );
+					::CloseHandle( shared->handles[i] );
+				#else
+					::pthread_join( shared->handles[i], NULL );
+				#endif
+				}
+
+				delete shared;
+				shared = NULL;
+			}
+
+		#endif
+
+			threads = 0;
+		}
+
+		Result ThreadPool::SetThreads(const uint count)
+		{
+			if (count > MAX_THREADS)
+				return RESULT_ERR_INVALID_PARAM;
+
+			if (count == threads)
+				return RESULT_NOP;
+
+			NST_VERIFY( !job );
+
+		#ifdef NST_NO_THREADS
+
+			return RESULT_ERR_UNSUPPORTED;
+
+		#else
+
+			Destroy();
+
+			if (!count)
+				return RESULT_OK;
+
+			try
+			{
+				shared = new Shared;
+			}
+			catch (Result result)
+			{
+				return result;
+			}
+			catch (const std::bad_alloc&)
+			{
+				return RESULT_ERR_OUT_OF_MEMORY;
+			}
+
+			while (threads < count)
+			{
+			#ifdef NST_WIN32
+				shared->handles[threads] = reinterpret_cast<HANDLE>(::_beginthreadex( NULL, 0, Shared::Entry, shared, 0, NULL ));
+
+				if (!shared->handles[threads])
+			#else
+				if (::pthread_create( shared->handles + threads, NULL, Shared::Entry, shared ))
+			#endif
+				{
+					Destroy();
+					return RESULT_ERR_GENERIC;
+				}
+
+				++threads;
+			}
+
+			return RESULT_OK;
+
+		#endif
+		}
+
+		uint ThreadPool::NumProcessors()
+		{
+		#if defined(NST_NO_THREADS)
+			return 1;
+		#elif defined(NST_WIN32)
+			SYSTEM_INFO info;
+			::GetSystemInfo( &info );
+			return info.dwNumberOfProcessors > 1 ? info.dwNumberOfProcessors : 1;
+		#elif defined(_SC_NPROCESSORS_ONLN)
+			const long count = ::sysconf( _SC_NPROCESSORS_ONLN );
+			return count > 1 ? count : 1;
+		#else
+			return 1;
+		#endif
+		}
+
+		ulong ThreadPool::Milliseconds()
+		{
+		#if defined(NST_NO_THREADS)
+			return ulong(std::clock()) * 1000 / CLOCKS_PER_SEC;
+		#elif defined(NST_WIN32)
+			return ::GetTickCount();
+		#else
+			timeval tv;
+			::gettimeofday( &tv, NULL );
+			return ulong(tv.tv_sec) * 1000 + ulong(tv.tv_usec) / 1000;
+		#endif
+		}
+
+		#ifdef NST_MSVC_OPTIMIZE
+		#pragma optimize("", on)
+		#endif
+
+		void ThreadPool::Start(Job& j,const uint n)
+		{
+			NST_VERIFY( !job );
+
+			job = &j;
+			parts = n;
+
+		#ifndef NST_NO_THREADS
+
+			if (shared)
+			{
+				shared->mutex.Lock();
+				shared->job = &j;
+				shared->parts = n;
+				shared->next = 0;
+				shared->mutex.Unlock();
+
+				shared->start.Post( NST_MIN(threads,n) );
+			}
+
+		#endif
+		}
+
+		void ThreadPool::Wait()
+		{
+			if (job)
+			{
+			#ifndef NST_NO_THREADS
+
+				if (shared)
+				{
+					while (shared->Execute());
+
+					for (uint i=parts; i; --i)
+						shared->done.Wait();
+				}
+				else
+
+			#endif
+				{
+					for (uint i=0; i < parts; ++i)
+						job->Execute( i );
+				}
+
+				job = NULL;
+			}
+		}
+	}
+}
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NST_THREADPOOL_H
+#define NST_THREADPOOL_H
+
+#ifdef NST_PRAGMA_ONCE
+#pragma once
+#endif
+
+namespace Nes
+{
+	namespace Core
+	{
+		class ThreadPool
+		{
+		public:
+
+			ThreadPool();
+			~ThreadPool();
+
+			class NST_NO_VTABLE Job
+			{
+			public:
+
+				virtual void Execute(uint) = 0;
+
+			protected:
+
+				virtual ~Job() {}
+			};
+
+			enum
+			{
+				MAX_THREADS = 15
+			};
+
+			Result SetThreads(uint);
+			void Start(Job&,uint);
+			void Wait();
+
+			static uint NumProcessors();
+			static ulong Milliseconds();
+
+		private:
+
+			class Mutex;
+			class Semaphore;
+			struct Shared;
+
+			void Destroy();
+
+			Shared* shared;
+			Job* job;
+			uint parts;
+			uint threads;
+
+		public:
+
+			void Run(Job& j,uint n)
+			{
+				Start( j, n );
+				Wait();
+			}
+
+			uint NumThreads() const
+			{
+				return threads;
+			}
+		};
+	}
+}
+
+#endif
@@ -43,6 +43,11 @@ namespace Nes
 	{
 		namespace Timer
 		{
+			// Unit::Pending() returns the number of calls to Unit::Clock() up to and
+			// including the next one that may signal or otherwise have an effect
+			// outside the unit, or 0 if none will until the unit is written to.
+			// A smaller number is always safe, it only costs an early wake-up.
+
 			template<typename Unit,uint Divider=1>
 			class M2
 			{
@@ -63,7 +68,8 @@ namespace Nes
 
 				enum
 				{
-					IRQ_SETUP = 2
+					IRQ_SETUP = 2,
+					PENDING_MAX = 0x10000
 				};
 
 				NES_DECL_HOOK( Signaled );
@@ -79,6 +85,7 @@ namespace Nes
 				bool Connect(bool connect)
 				{
 					connected = connect;
+					Reschedule();
 					return connect;
 				}
 
@@ -90,6 +97,12 @@ namespace Nes
 				void Update()
 				{
 					M2::NES_DO_HOOK( Signaled );
+					Reschedule();
+				}
+
+				void Reschedule()
+				{
+					cpu.ScheduleEvent( Hook(this,&M2::Hook_Signaled), cpu.GetCycles() );
 				}
 
 				void ClearIRQ() const
@@ -124,19 +137,33 @@ namespace Nes
 				count = 0;
 				connected = connect;
 				unit.Reset( hard );
-				cpu.AddHook( Hook(this,&M2::Hook_Signaled) );
+				cpu.AddEvent( Hook(this,&M2::Hook_Signaled) );
 			}
 
 			NES_HOOK_T(template<typename Unit NST_COMMA uint Divider>,M2<Unit NST_COMMA Divider>,Signaled)
 			{
 				NST_COMPILE_ASSERT( Divider <= 8 );
 
-				while (count <= cpu.GetCycles())
+				const Cycle clock = cpu.GetClock(Divider);
+
+				if (connected)
 				{
-					if (connected && unit.Clock())
-						cpu.DoIRQ( Cpu::IRQ_EXT, count + cpu.GetClock(IRQ_SETUP) );
+					while (count <= cpu.GetCycles())
+					{
+						if (unit.Clock())
+							cpu.DoIRQ( Cpu::IRQ_EXT, count + cpu.GetClock(IRQ_SETUP) );
 
-					count += cpu.GetClock(Divider);
+						count += clock;
+					}
+
+					// no need to look at the unit again until the next clock that may signal
+
+					if (const dword pending = unit.Pending())
+						cpu.ScheduleEvent( Hook(this,&M2::Hook_Signaled), count + (NST_MIN(pending,dword(PENDING_MAX)) - 1) * clock );
+				}
+				else if (count <= cpu.GetCycles())
+				{
+					count += ((cpu.GetCycles() - count) / clock + 1) * clock;
 				}
 			}
 
@@ -26,8 +26,12 @@
 #include "NstMachine.hpp"
 #include "NstTrackerMovie.hpp"
 #include "NstTrackerRewinder.hpp"
+#include "NstState.hpp"
 #include "NstImage.hpp"
+#include "api/NstApiEmulator.hpp"
+#include "api/NstApiInput.hpp"
 #include "api/NstApiMachine.hpp"
+#include "api/NstApiRewinder.hpp"
 
 namespace Nes
 {
@@ -41,9 +45,14 @@ namespace Nes
 		:
 		frame           (0),
 		rewinderSound   (false),
+		rewinderMemory  (Api::Rewinder::DEFAULT_MEMORY_LIMIT),
 		rewinderEnabled (NULL),
 		rewinder        (NULL),
-		movie           (NULL)
+		movie           (NULL),
+		runAhead        (0),
+		runningAhead    (false),
+		inputQueue      (NULL),
+		inputQueued     (0)
 		{}
 
 		Tracker::~Tracker()
@@ -56,6 +65,8 @@ namespace Nes
 		{
 			frame = 0;
 
+			QueueInput( NULL, 0 );
+
 			if (rewinder)
 				rewinder->Unload();
 			else
@@ -78,9 +89,18 @@ namespace Nes
 
 		void Tracker::PowerOff()
 		{
+			runningAhead = false;
 			StopMovie();
 		}
 
+		void Tracker::QueueInput(Input::Controllers* const input,const dword count)
+		{
+			NST_ASSERT( input || !count );
+
+			inputQueue = input;
+			inputQueued = count;
+		}
+
 		void Tracker::Resync(bool excludeFrame) const
 		{
 			if (rewinder)
@@ -122,6 +142,38 @@ namespace Nes
 				rewinder->EnableSound( enable );
 		}
 
+		Result Tracker::SetRewinderMemory(dword size)
+		{
+			if (size < Api::Rewinder::MIN_MEMORY_LIMIT)
+				return RESULT_ERR_INVALID_PARAM;
+
+			if (rewinderMemory == size)
+				return RESULT_NOP;
+
+			rewinderMemory = size;
+
+			if (rewinder)
+				rewinder->SetMemoryLimit( size );
+
+			return RESULT_OK;
+		}
+
+		Result Tracker::SetRunAhead(uint frames)
+		{
+			if (frames > Api::Emulator::MAX_RUN_AHEAD)
+				return RESULT_ERR_INVALID_PARAM;
+
+			if (runAhead == frames)
+				return RESULT_NOP;
+
+			runAhead = frames;
+
+			if (!frames)
+				aheadState.Destroy();
+
+			return RESULT_OK;
+		}
+
 		void Tracker::ResetRewinder() const
 		{
 			if (rewinder)
@@ -143,7 +195,8 @@ namespace Nes
 						rewinderEnabled->cpu,
 						rewinderEnabled->cpu.GetApu(),
 						rewinderEnabled->ppu,
-						rewinderSound
+						rewinderSound,
+						rewinderMemory
 					);
 				}
 			}
@@ -309,6 +362,12 @@ namespace Nes
 			{
 				++frame;
 
+				if (inputQueued)
+				{
+					input = inputQueue++;
+					--inputQueued;
+				}
+
 				try
 				{
 					if (machine.Is(Api::Machine::GAME))
@@ -331,7 +390,11 @@ namespace Nes
 						}
 					}
 
-					machine.Execute( video, sound, input );
+					if (runAhead && !movie && machine.Is(Api::Machine::GAME))
+						ExecuteAhead( machine, video, sound, input );
+					else
+						machine.Execute( video, sound, input );
+
 					return RESULT_OK;
 				}
 				catch (Result result)
@@ -352,5 +415,106 @@ namespace Nes
 				return RESULT_ERR_NOT_READY;
 			}
 		}
+
+		void Tracker::ExecuteAhead
+		(
+			Machine& machine,
+			Video::Output* const video,
+			Sound::Output* const sound,
+			Input::Controllers* const input
+		)
+		{
+			NST_ASSERT( runAhead );
+
+			machine.Execute( NULL, sound, input );
+
+			for (;;)
+			{
+				try
+				{
+					State::Saver saver( aheadState.Begin(), aheadState.Capacity() );
+					machine.SaveState( saver );
+					aheadState.SetTo( saver.Size() );
+					break;
+				}
+				catch (Result result)
+				{
+					if (result != RESULT_ERR_OUT_OF_MEMORY)
+						throw;
+				}
+
+				State::Saver counter( NULL, 0xFFFFFFFF );
+				machine.SaveState( counter );
+				aheadState.Reserve( counter.Size() );
+			}
+
+			runningAhead = true;
+
+			for (uint i=1; i < runAhead; ++i)
+				machine.Execute( NULL, NULL, input );
+
+			machine.Execute( video, NULL, input );
+
+			runningAhead = false;
+
+			State::Loader loader( aheadState.Begin(), aheadState.Size(), false );
+			machine.LoadState( loader, true );
+		}
+
+		Result Tracker::ExecuteFrames(Machine& machine,const dword count,const bool stopOnJam)
+		{
+			if (!machine.Is(Api::Machine::ON))
+				return RESULT_ERR_NOT_READY;
+
+			if (!count)
+				return RESULT_NOP;
+
+			if (machine.Is(Api::Machine::GAME) && (rewinder || movie))
+			{
+				for (dword i=0; i < count; ++i)
+				{
+					const Result result = Execute( machine, NULL, NULL, NULL );
+
+					if (NES_FAILED(result))
+						return result;
+
+					if (stopOnJam && machine.cpu.IsJammed())
+						return i+1 == count ? RESULT_OK : RESULT_NOP;
+				}
+
+				return RESULT_OK;
+			}
+
+			try
+			{
+				dword executed = 0;
+
+				if (inputQueued)
+				{
+					executed = machine.ExecuteFrames( NST_MIN(count,inputQueued), stopOnJam, inputQueue );
+					inputQueue += executed;
+					inputQueued -= executed;
+				}
+
+				if (executed != count && !(stopOnJam && machine.cpu.IsJammed()))
+					executed += machine.ExecuteFrames( count - executed, stopOnJam, NULL );
+
+				frame += executed;
+
+				return executed == count ? RESULT_OK : RESULT_NOP;
+			}
+			catch (Result result)
+			{
+				return machine.PowerOff( result );
+			}
+			catch (const std::bad_alloc&)
+			{
+				return machine.PowerOff( RESULT_ERR_OUT_OF_MEMORY );
+			}
+			catch (...)
+			{
+				return machine.PowerOff( RESULT_ERR_GENERIC );
+			}
+		}
 	}
 }
@@ -25,6 +25,10 @@
 #ifndef NST_TRACKER_H
 #define NST_TRACKER_H
 
+#ifndef NST_VECTOR_H
+#include "NstVector.hpp"
+#endif
+
 #ifdef NST_PRAGMA_ONCE
 #pragma once
 #endif
@@ -60,14 +64,20 @@ namespace Nes
 			void   Reset();
 			void   PowerOff();
 			Result Execute(Machine&,Video::Output*,Sound::Output*,Input::Controllers*);
+			Result ExecuteFrames(Machine&,dword,bool);
 			void   Resync(bool=false) const;
 			Result TryResync(Result,bool=false) const;
 			void   Unload();
 			bool   IsActive() const;
 			bool   IsLocked(bool=false) const;
 
+			void   QueueInput(Input::Controllers*,dword);
+
+			Result SetRunAhead(uint);
+
 			Result EnableRewinder(Machine*);
 			void   EnableRewinderSound(bool);
+			Result SetRewinderMemory(dword);
 			void   ResetRewinder() const;
 			Result StartRewinding() const;
 			Result StopRewinding() const;
@@ -82,15 +92,22 @@ namespace Nes
 		private:
 
 			void UpdateRewinderState(bool);
+			void ExecuteAhead(Machine&,Video::Output*,Sound::Output*,Input::Controllers*);
 
 			class Movie;
 			class Rewinder;
 
 			dword frame;
 			ibool rewinderSound;
+			dword rewinderMemory;
 			Machine* rewinderEnabled;
 			Rewinder* rewinder;
 			Movie* movie;
+			uint runAhead;
+			ibool runningAhead;
+			Vector<byte> aheadState;
+			Input::Controllers* inputQueue;
+			dword inputQueued;
 
 		public:
 
@@ -104,15 +121,35 @@ namespace Nes
 				return rewinderSound;
 			}
 
+			dword GetRewinderMemory() const
+			{
+				return rewinderMemory;
+			}
+
+			uint GetRunAhead() const
+			{
+				return runAhead;
+			}
+
 			bool IsFrameLocked() const
 			{
 				return movie;
 			}
 
+			bool IsRunningAhead() const
+			{
+				return runningAhead;
+			}
+
 			dword Frame() const
 			{
 				return frame;
 			}
+
+			dword NumQueuedInput() const
+			{
+				return inputQueued;
+			}
 		};
 	}
 }
@@ -24,7 +24,6 @@
 
 #include <cstdlib>
 #include <cstring>
-#include <string>
 #include <algorithm>
 #include "NstMachine.hpp"
 #include "NstState.hpp"
@@ -86,36 +85,27 @@ namespace Nes
 
 		class Tracker::Rewinder::ReverseSound::Mutex
 		{
-			Output::LockCallback funcLock;
-			void* userLock;
-			Output::UnlockCallback funcUnlock;
-			void* userUnlock;
-
 		public:
 
-			Mutex()
-			{
-				Output::lockCallback.Get( funcLock, userLock );
-				Output::unlockCallback.Get( funcUnlock, userUnlock );
-				Output::lockCallback.Set( NULL, NULL );
-				Output::unlockCallback.Set( NULL, NULL );
-			}
+			Mutex() {}
 
 			bool Lock(Output& output) const
 			{
-				return funcLock ? funcLock( userLock, output ) : true;
+				return Output::lockCallback( output );
 			}
 
 			void Unlock(Output& output) const
 			{
-				if (funcUnlock)
-					funcUnlock( userUnlock, output );
+				Output::unlockCallback( output );
 			}
 
-			~Mutex()
+			static bool NST_CALLBACK BypassLock(void*,Output&)
+			{
+				return true;
+			}
+
+			static void NST_CALLBACK BypassUnlock(void*,Output&)
 			{
-				Output::lockCallback.Set( funcLock, userLock );
-				Output::unlockCallback.Set( funcUnlock, userUnlock );
 			}
 		};
 
@@ -143,11 +133,23 @@ namespace Nes
 		size    (0),
 		input   (NULL),
 		apu     (a)
-		{}
+		{
+			// the internal buffer is never handed to the user callbacks
+
+			output.lockFunction = Mutex::BypassLock;
+			output.unlockFunction = Mutex::BypassUnlock;
+		}
+
+		Tracker::Rewinder::Keyframes::Keyframes(dword size)
+		: capacity(size)
+		{
+			Reset();
+		}
 
-		Tracker::Rewinder::Rewinder(Machine& e,EmuExecute x,EmuLoadState l,EmuSaveState s,Cpu& c,const Apu& a,Ppu& p,bool b)
+		Tracker::Rewinder::Rewinder(Machine& e,EmuExecute x,EmuLoadState l,EmuSaveState s,Cpu& c,const Apu& a,Ppu& p,bool b,dword m)
 		:
 		rewinding    (false),
+		keyframes    (m),
 		sound        (a,b),
 		video        (p),
 		emulator     (e),
@@ -190,24 +192,36 @@ namespace Nes
 			}
 		}
 
-		Tracker::Rewinder::Key::Key()
+		void Tracker::Rewinder::InputLog::Reset()
 		{
+			pos = BAD_POS;
+			buffer.Destroy();
 		}
 
-		Tracker::Rewinder::Key::~Key()
+		void Tracker::Rewinder::Keyframes::Reset()
 		{
+			head = 0;
+			counter = 0;
+			reference = 0;
+
+			for (uint i=0; i < NUM_KEYS; ++i)
+			{
+				blocks[i].id = 0;
+				blocks[i].inputSize = NO_INPUT;
+			}
 		}
 
-		void Tracker::Rewinder::Key::Input::Reset()
+		void Tracker::Rewinder::Keyframes::SetCapacity(dword size)
 		{
-			pos = BAD_POS;
-			buffer.Destroy();
+			capacity = size;
+			arena.Destroy();
+			Reset();
 		}
 
-		void Tracker::Rewinder::Key::Reset()
+		void Tracker::Rewinder::SetMemoryLimit(dword size)
 		{
-			stream.str( std::string() );
-			input.Reset();
+			keyframes.SetCapacity( size );
+			Reset( true );
 		}
 
 		void Tracker::Rewinder::Reset(bool on)
@@ -223,10 +237,10 @@ namespace Nes
 
 			uturn = false;
 			frame = LAST_FRAME;
-			key = keys + LAST_KEY;
+			key = LAST_KEY;
 
-			for (uint i=0; i < NUM_FRAMES; ++i)
-				keys[i].Reset();
+			input.Reset();
+			keyframes.Reset();
 
 			LinkPorts( on );
 		}
@@ -308,75 +322,40 @@ namespace Nes
 		#pragma optimize("", on)
 		#endif
 
-		inline void Tracker::Rewinder::Key::Input::Invalidate()
-		{
-			pos = BAD_POS;
-		}
-
-		inline void Tracker::Rewinder::Key::Input::BeginForward()
+		inline void Tracker::Rewinder::InputLog::BeginForward()
 		{
-			const dword hint = pos;
 			pos = 0;
 			buffer.Clear();
-
-			if (hint != BAD_POS)
-				buffer.Reserve( hint );
 		}
 
-		bool Tracker::Rewinder::Key::Input::EndForward()
+		void Tracker::Rewinder::InputLog::EndForward(Keyframes& keyframes,const uint i) const
 		{
 			if (pos == 0)
-			{
-				pos = buffer.Size();
-
-				if (Zlib::AVAILABLE && pos >= MIN_COMPRESSION_SIZE)
-				{
-					Buffer tmp( pos - 1 );
-
-					if (const dword size = Zlib::Compress( buffer.Begin(), buffer.Size(), tmp.Begin(), tmp.Size(), Zlib::NORMAL_COMPRESSION ))
-					{
-						NST_ASSERT( size < pos );
-						tmp.SetTo( size );
-						Buffer::Swap( tmp, buffer );
-					}
-					else
-					{
-						NST_DEBUG_MSG("compress() in Tracker::Rewinder::Key::Input failed!");
-					}
-
-					buffer.Defrag();
-				}
-
-				return true;
-			}
-
-			return false;
+				keyframes.SaveInput( i, buffer );
+			else
+				keyframes.InvalidateInput( i );
 		}
 
-		void Tracker::Rewinder::Key::Input::BeginBackward()
+		inline void Tracker::Rewinder::InputLog::BeginBackward()
 		{
-			dword size = pos;
+			NST_VERIFY( CanRewind() );
 			pos = 0;
-
-			if (Zlib::AVAILABLE && size > buffer.Size())
-			{
-				Buffer tmp( size );
-				size = Zlib::Uncompress( buffer.Begin(), buffer.Size(), tmp.Begin(), tmp.Size() );
-
-				if (!size)
-					throw RESULT_ERR_CORRUPT_FILE;
-
-				NST_VERIFY( size == tmp.Size() );
-				Buffer::Swap( tmp, buffer );
-			}
 		}
 
-		inline void Tracker::Rewinder::Key::Input::EndBackward()
+		void Tracker::Rewinder::InputLog::BeginBackward(const Keyframes& keyframes,const uint i)
 		{
-			pos = 0;
+			if (keyframes.LoadInput( i, buffer ))
+			{
+				pos = 0;
+			}
+			else
+			{
+				buffer.Clear();
+				pos = BAD_POS;
+			}
 		}
 
-		inline void Tracker::Rewinder::Key::Input::ResumeForward()
+		inline void Tracker::Rewinder::InputLog::ResumeForward()
 		{
 			NST_VERIFY( pos != BAD_POS );
 			dword size = pos;
@@ -384,12 +363,12 @@ namespace Nes
 			buffer.Resize( size != BAD_POS ? size : 0 );
 		}
 
-		inline bool Tracker::Rewinder::Key::Input::CanRewind() const
+		inline bool Tracker::Rewinder::InputLog::CanRewind() const
 		{
 			return pos != BAD_POS;
 		}
 
-		inline uint Tracker::Rewinder::Key::Input::Put(const uint data)
+		inline uint Tracker::Rewinder::InputLog::Put(const uint data)
 		{
 			if (pos != BAD_POS)
 			{
@@ -407,7 +386,7 @@ namespace Nes
 			return data;
 		}
 
-		inline uint Tracker::Rewinder::Key::Input::Get()
+		inline uint Tracker::Rewinder::InputLog::Get()
 		{
 			if (pos < buffer.Size())
 			{
@@ -421,99 +400,405 @@ namespace Nes
 			}
 		}
 
-		inline void Tracker::Rewinder::Key::Invalidate()
+		inline uint Tracker::Rewinder::Keyframes::PrevIndex(uint i)
 		{
-			input.Invalidate();
+			return i ? i-1 : LAST_KEY;
 		}
 
-		inline bool Tracker::Rewinder::Key::CanRewind() const
+		inline uint Tracker::Rewinder::Keyframes::NextIndex(uint i)
 		{
-			return input.CanRewind();
+			return i != LAST_KEY ? i+1 : 0;
 		}
 
-		inline void Tracker::Rewinder::Key::ResumeForward()
+		inline byte* Tracker::Rewinder::Keyframes::WriteLength(byte* dst,dword length)
 		{
-			input.ResumeForward();
+			for (; length >= 0x80; length >>= 7)
+				*dst++ = 0x80 | (length & 0x7F);
+
+			*dst++ = length;
+
+			return dst;
 		}
 
-		void Tracker::Rewinder::Key::BeginForward(Machine& emulator,EmuSaveState saveState,EmuLoadState loadState)
+		inline dword Tracker::Rewinder::Keyframes::ReadLength(const byte*& src,const byte* const end)
 		{
-			NST_ASSERT( !saveState || !loadState );
+			dword length = 0;
 
-			input.BeginForward();
+			for (uint shift=0; src != end && shift < 32; shift += 7)
+			{
+				const uint data = *src++;
+				length |= dword(data & 0x7F) << shift;
+
+				if (!(data & 0x80))
+					return length;
+			}
+
+			throw RESULT_ERR_CORRUPT_FILE;
+		}
+
+		byte* Tracker::Rewinder::Keyframes::Encode(const byte* const src,const dword size,const byte* const ref,dword refSize,byte* dst,const byte* const end)
+		{
+			if (refSize > size)
+				refSize = size;
 
-			if (saveState)
+			for (dword pos=0; pos < size; )
 			{
-				stream.clear();
-				stream.seekp( 0, std::stringstream::beg );
-				stream.clear();
+				const dword zeros = pos;
 
-				State::Saver saver( &static_cast<std::ostream&>(stream), false, true );
-				(emulator.*saveState)( saver );
+				while (pos < size && src[pos] == (pos < refSize ? ref[pos] : 0))
+					++pos;
+
+				const dword start = pos;
+
+				for (uint run=0; pos < size; ++pos)
+				{
+					if (src[pos] != (pos < refSize ? ref[pos] : 0))
+					{
+						run = 0;
+					}
+					else if (++run == MIN_ZERO_RUN)
+					{
+						pos -= MIN_ZERO_RUN-1;
+						break;
+					}
+				}
+
+				// two lengths take at most five bytes each
+
+				if (dword(end - dst) < 5 + 5 + (pos - start))
+					return NULL;
+
+				dst = WriteLength( dst, start - zeros );
+				dst = WriteLength( dst, pos - start );
+
+				for (dword i=start; i < pos; ++i)
+					*dst++ = src[i] ^ (i < refSize ? ref[i] : 0);
 			}
-			else if (loadState)
+
+			return dst;
+		}
+
+		void Tracker::Rewinder::Keyframes::Decode(const byte* src,const dword length,byte* const dst,const dword size,const bool delta)
+		{
+			const byte* const end = src + length;
+			dword pos = 0;
+
+			while (src != end)
 			{
-				TurnForward( emulator, loadState );
+				const dword zeros = ReadLength( src, end );
+				const dword literals = ReadLength( src, end );
+
+				if (size - pos < zeros || size - pos - zeros < literals || dword(end - src) < literals)
+					throw RESULT_ERR_CORRUPT_FILE;
+
+				if (!delta)
+					std::memset( dst + pos, 0, zeros );
+
+				pos += zeros;
+
+				if (delta)
+				{
+					for (const byte* const stop = src + literals; src != stop; ++src)
+						dst[pos++] ^= *src;
+				}
+				else
+				{
+					std::memcpy( dst + pos, src, literals );
+					pos += literals;
+					src += literals;
+				}
 			}
+
+			if (pos != size)
+				throw RESULT_ERR_CORRUPT_FILE;
 		}
 
-		void Tracker::Rewinder::Key::EndForward()
+		bool Tracker::Rewinder::Keyframes::CanLoad(uint i) const
 		{
-			if (!input.EndForward())
-				Reset();
+			for (;;)
+			{
+				const Block& block = blocks[i];
+
+				if (!block.id)
+					return false;
+
+				if (!block.base)
+					return true;
+
+				i = PrevIndex( i );
+
+				if (blocks[i].id != block.base)
+					return false;
+			}
+		}
+
+		bool Tracker::Rewinder::Keyframes::CanRewind(const uint i) const
+		{
+			return blocks[i].inputSize != NO_INPUT && CanLoad( i );
 		}
 
-		void Tracker::Rewinder::Key::TurnForward(Machine& emulator,EmuLoadState loadState)
+		void Tracker::Rewinder::Keyframes::Discard(const dword begin,const dword end)
 		{
-			stream.clear();
-			stream.seekg( 0, std::stringstream::beg );
-			stream.clear();
+			for (uint i=0; i < NUM_KEYS; ++i)
+			{
+				Block& block = blocks[i];
 
-			State::Loader loader( &static_cast<std::istream&>(stream), false );
-			(emulator.*loadState)( loader, true );
+				if (block.id && block.offset < end && begin < block.offset + block.length)
+					block.id = 0;
+
+				if (block.inputSize != NO_INPUT && block.inputLength && block.input < end && begin < block.input + block.inputLength)
+					block.inputSize = NO_INPUT;
+			}
 		}
 
-		void Tracker::Rewinder::Key::BeginBackward(Machine& emulator,EmuLoadState loadState)
+		void Tracker::Rewinder::Keyframes::Store(const uint i,const byte* const ref,const dword refSize,const dword base,const uint depth)
 		{
-			NST_VERIFY( CanRewind() );
+			Block& block = blocks[i];
+
+			block.id = 0;
+			block.inputSize = NO_INPUT;
+
+			if (arena.Size() != capacity)
+				arena.Resize( capacity );
+
+			const byte* end = Encode( state.Begin(), state.Size(), ref, refSize, arena.Begin() + head, arena.End() );
+
+			if (!end)
+			{
+				// the tail has been partly overwritten, wrap around and retry from the start
+
+				Discard( head, capacity );
+
+				if (!head)
+					return;
 
-			TurnForward( emulator, loadState );
-			input.BeginBackward();
+				head = 0;
+				end = Encode( state.Begin(), state.Size(), ref, refSize, arena.Begin(), arena.End() );
+
+				if (!end)
+				{
+					Discard( 0, capacity );
+					return;
+				}
+			}
+
+			const dword length = end - (arena.Begin() + head);
+
+			Discard( head, head + length );
+
+			block.id = ++counter;
+			block.base = base;
+			block.offset = head;
+			block.length = length;
+			block.size = state.Size();
+			block.depth = depth;
+
+			head += length;
 		}
 
-		inline void Tracker::Rewinder::Key::EndBackward()
+		void Tracker::Rewinder::Keyframes::Save(const uint i,Machine& emulator,EmuSaveState saveState)
 		{
-			input.EndBackward();
+			try
+			{
+				State::Saver saver( state.Begin(), state.Capacity(), true );
+				(emulator.*saveState)( saver );
+				state.SetTo( saver.Size() );
+			}
+			catch (Result result)
+			{
+				if (result != RESULT_ERR_OUT_OF_MEMORY)
+					throw;
+
+				// an internal save may skip data it has seen before, so the
+				// retry after growing the buffer must write everything
+
+				{
+					State::Saver counter( NULL, 0xFFFFFFFF );
+					(emulator.*saveState)( counter );
+					state.Reserve( counter.Size() );
+				}
+
+				State::Saver saver( state.Begin(), state.Capacity() );
+				(emulator.*saveState)( saver );
+				state.SetTo( saver.Size() );
+			}
+
+			NST_VERIFY( state.Size() );
+
+			const Block& prev = blocks[PrevIndex(i)];
+
+			if (reference && prev.id == reference && prev.depth < MAX_DEPTH-1)
+				Store( i, current.Begin(), current.Size(), prev.id, prev.depth + 1 );
+			else
+				Store( i, NULL, 0, 0, 0 );
+
+			Buffer::Swap( state, current );
+			reference = blocks[i].id;
 		}
 
-		inline uint Tracker::Rewinder::Key::Put(uint data)
+		void Tracker::Rewinder::Keyframes::SaveInput(const uint i,const Buffer& input)
 		{
-			return input.Put( data );
+			Block& block = blocks[i];
+			block.inputSize = NO_INPUT;
+
+			const dword size = input.Size();
+
+			if (!block.id || size > capacity)
+				return;
+
+			if (capacity - head < size)
+				head = 0;
+
+			byte* const dst = arena.Begin() + head;
+			dword length = 0;
+
+			if (Zlib::AVAILABLE && size >= MIN_COMPRESSION_SIZE)
+				length = Zlib::Compress( input.Begin(), size, dst, size - 1, Zlib::NORMAL_COMPRESSION );
+
+			if (!length && size)
+			{
+				std::memcpy( dst, input.Begin(), size );
+				length = size;
+			}
+
+			if (length)
+				Discard( head, head + length );
+
+			if (block.id)
+			{
+				block.input = head;
+				block.inputLength = length;
+				block.inputSize = size;
+			}
+
+			head += length;
 		}
 
-		inline uint Tracker::Rewinder::Key::Get()
+		bool Tracker::Rewinder::Keyframes::LoadInput(const uint i,Buffer& input) const
 		{
-			return input.Get();
+			const Block& block = blocks[i];
+
+			if (block.inputSize == NO_INPUT)
+				return false;
+
+			input.Resize( block.inputSize );
+
+			if (block.inputLength < block.inputSize)
+			{
+				if (!Zlib::AVAILABLE || Zlib::Uncompress( arena.Begin() + block.input, block.inputLength, input.Begin(), block.inputSize ) != block.inputSize)
+					throw RESULT_ERR_CORRUPT_FILE;
+			}
+			else if (block.inputSize)
+			{
+				std::memcpy( input.Begin(), arena.Begin() + block.input, block.inputSize );
+			}
+
+			return true;
 		}
 
-		inline Tracker::Rewinder::Key* Tracker::Rewinder::PrevKey(Key* k)
+		void Tracker::Rewinder::Keyframes::InvalidateInput(const uint i)
 		{
-			return (k != keys ? k-1 : keys+LAST_KEY);
+			blocks[i].inputSize = NO_INPUT;
 		}
 
-		inline Tracker::Rewinder::Key* Tracker::Rewinder::PrevKey()
+		void Tracker::Rewinder::Keyframes::Restore(const uint i)
 		{
-			return PrevKey( key );
+			NST_VERIFY( CanLoad(i) );
+
+			if (blocks[i].id && blocks[i].id == reference)
+				return;
+
+			{
+				const Block& next = blocks[NextIndex(i)];
+
+				if (reference && next.id == reference && next.base == blocks[i].id && blocks[i].size <= next.size)
+				{
+					Decode( arena.Begin() + next.offset, next.length, current.Begin(), next.size, true );
+					current.SetTo( blocks[i].size );
+					reference = blocks[i].id;
+					return;
+				}
+			}
+
+			const dword target = blocks[i].id;
+			uint chain[MAX_DEPTH];
+			uint length = 0;
+
+			for (uint j=i;;)
+			{
+				const Block& block = blocks[j];
+
+				if (!block.id)
+					throw RESULT_ERR_CORRUPT_FILE;
+
+				if (block.id == reference)
+					break;
+
+				if (!block.base)
+				{
+					reference = 0;
+					current.Resize( block.size );
+					Decode( arena.Begin() + block.offset, block.length, current.Begin(), block.size, false );
+					break;
+				}
+
+				NST_VERIFY( length < MAX_DEPTH );
+
+				if (length == MAX_DEPTH)
+					throw RESULT_ERR_CORRUPT_FILE;
+
+				chain[length++] = j;
+				j = PrevIndex( j );
+
+				if (blocks[j].id != block.base)
+					throw RESULT_ERR_CORRUPT_FILE;
+			}
+
+			reference = 0;
+
+			while (length)
+			{
+				const Block& block = blocks[chain[--length]];
+				const dword size = current.Size();
+
+				current.Resize( block.size );
+
+				if (block.size > size)
+					std::memset( current.Begin() + size, 0, block.size - size );
+
+				Decode( arena.Begin() + block.offset, block.length, current.Begin(), block.size, true );
+			}
+
+			reference = target;
 		}
 
-		inline Tracker::Rewinder::Key* Tracker::Rewinder::NextKey(Key* k)
+		void Tracker::Rewinder::Keyframes::Load(const uint i,Machine& emulator,EmuLoadState loadState)
 		{
-			return (k != keys+LAST_KEY ? k+1 : keys);
+			Restore( i );
+
+			State::Loader loader( current.Begin(), current.Size(), false );
+			(emulator.*loadState)( loader, true );
 		}
 
-		inline Tracker::Rewinder::Key* Tracker::Rewinder::NextKey()
+		void Tracker::Rewinder::SaveKey()
 		{
-			return NextKey( key );
+			input.BeginForward();
+			keyframes.Save( key, emulator, emuSaveState );
+		}
+
+		void Tracker::Rewinder::LoadKey(const uint k)
+		{
+			keyframes.Load( k, emulator, emuLoadState );
+		}
+
+		inline uint Tracker::Rewinder::PrevKey() const
+		{
+			return Keyframes::PrevIndex( key );
+		}
+
+		inline uint Tracker::Rewinder::NextKey() const
+		{
+			return Keyframes::NextIndex( key );
 		}
 
 		inline void Tracker::Rewinder::ReverseVideo::Flush(const Mutex& mutex)
@@ -660,9 +945,9 @@ namespace Nes
 					if (++frame == NUM_FRAMES)
 					{
 						frame = 0;
-						key->EndForward();
+						input.EndForward( keyframes, key );
 						key = NextKey();
-						key->BeginForward( emulator, emuSaveState, NULL );
+						SaveKey();
 					}
 				}
 				else
@@ -670,22 +955,23 @@ namespace Nes
 					if (++frame == NUM_FRAMES)
 					{
 						frame = 0;
-						key->EndBackward();
 
-						Key* const prev = PrevKey();
+						const uint prev = PrevKey();
 
-						if (prev->CanRewind())
+						if (keyframes.CanRewind( prev ))
 						{
-							prev->BeginBackward( emulator, emuLoadState );
+							LoadKey( prev );
+							input.BeginBackward( keyframes, prev );
 							key = prev;
 						}
 						else
 						{
 							rewinding = false;
 
-							key->Invalidate();
+							keyframes.InvalidateInput( key );
 							key = NextKey();
-							key->BeginForward( emulator, NULL, emuLoadState );
+							input.BeginForward();
+							LoadKey( key );
 
 							Api::Rewinder::stateCallback( Api::Rewinder::STOPPED );
 
@@ -728,17 +1014,22 @@ namespace Nes
 				for (uint i=frame; i < LAST_FRAME; ++i)
 					(emulator.*emuExecute)( NULL, NULL, NULL );
 
-				NextKey()->Invalidate();
+				keyframes.InvalidateInput( NextKey() );
 
 				video.Begin();
 				sound.Begin();
 
-				key->BeginBackward( emulator, emuLoadState );
+				LoadKey( key );
+
+				// commit the input so far in case rewinding is stopped before
+				// the previous key and playback has to resume in this one
+
+				input.EndForward( keyframes, key );
+				input.BeginBackward();
 				LinkPorts();
 
 				{
 					const ReverseVideo::Mutex videoMutex( video );
-					const ReverseSound::Mutex soundMutex;
 
 					for (uint i=0; i < NUM_FRAMES; ++i)
 					{
@@ -768,13 +1059,14 @@ namespace Nes
 					{
 						frame = 0;
 						key = NextKey();
-						key->TurnForward( emulator, emuLoadState );
+						LoadKey( key );
+						input.BeginBackward( keyframes, key );
 					}
 
 					(emulator.*emuExecute)( NULL, NULL, NULL );
 				}
 
-				key->ResumeForward();
+				input.ResumeForward();
 
 				LinkPorts();
 
@@ -790,7 +1082,7 @@ namespace Nes
 			if (rewinding)
 				return RESULT_NOP;
 
-			if (uturn || !PrevKey()->CanRewind())
+			if (uturn || !keyframes.CanRewind( PrevKey() ))
 				return RESULT_ERR_NOT_READY;
 
 			uturn = true;
@@ -815,12 +1107,12 @@ namespace Nes
 
 		NES_PEEK_A(Tracker::Rewinder,Port_Put)
 		{
-			return key->Put( ports[address-0x4016]->Peek( address ) );
+			return input.Put( ports[address-0x4016]->Peek( address ) );
 		}
 
 		NES_PEEK(Tracker::Rewinder,Port_Get)
 		{
-			return key->Get();
+			return input.Get();
 		}
 
 		NES_POKE_AD(Tracker::Rewinder,Port)
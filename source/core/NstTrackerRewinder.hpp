@@ -25,7 +25,6 @@
 #ifndef NST_TRACKER_REWINDER_H
 #define NST_TRACKER_REWINDER_H
 
-#include <sstream>
 #include "api/NstApiSound.hpp"
 
 #ifndef NST_VECTOR_H
@@ -48,12 +47,13 @@ namespace Nes
 
 		public:
 
-			Rewinder(Machine&,EmuExecute,EmuLoadState,EmuSaveState,Cpu&,const Apu&,Ppu&,bool);
+			Rewinder(Machine&,EmuExecute,EmuLoadState,EmuSaveState,Cpu&,const Apu&,Ppu&,bool,dword);
 			~Rewinder();
 
 			Result Start();
 			Result Stop();
 			void   Execute(Video::Output*,Sound::Output*,Input::Controllers*);
+			void   SetMemoryLimit(dword);
 
 		private:
 
@@ -63,65 +63,102 @@ namespace Nes
 
 			enum
 			{
-				NUM_KEYS = 60,
+				NUM_KEYS = 600,
 				LAST_KEY = NUM_KEYS-1,
 				NUM_FRAMES = 60,
 				LAST_FRAME = NUM_FRAMES-1
 			};
 
-			class Key
-			{
-				class Input
-				{
-					typedef Vector<byte> Buffer;
+			typedef Vector<byte> Buffer;
 
-					enum
-					{
-						BAD_POS = INT_MAX,
-						MIN_COMPRESSION_SIZE = 1024,
-						OPEN_BUS = 0x40
-					};
+			class Keyframes
+			{
+			public:
 
-					dword pos;
-					Buffer buffer;
+				explicit Keyframes(dword);
 
-				public:
+				void Reset();
+				void SetCapacity(dword);
+				void Save(uint,Machine&,EmuSaveState);
+				void Load(uint,Machine&,EmuLoadState);
+				void SaveInput(uint,const Buffer&);
+				bool LoadInput(uint,Buffer&) const;
+				void InvalidateInput(uint);
+				bool CanLoad(uint) const;
+				bool CanRewind(uint) const;
+
+				static inline uint PrevIndex(uint);
+				static inline uint NextIndex(uint);
 
-					void Reset();
-					inline void BeginForward();
-					bool EndForward();
-					void BeginBackward();
-					inline void EndBackward();
+			private:
 
-					inline uint Put(uint);
-					inline uint Get();
+				enum
+				{
+					MAX_DEPTH = 16,
+					MIN_ZERO_RUN = 4,
+					MIN_COMPRESSION_SIZE = 1024,
+					NO_INPUT = INT_MAX
+				};
 
-					inline void ResumeForward();
-					inline bool CanRewind() const;
-					inline void Invalidate();
+				struct Block
+				{
+					dword id;
+					dword base;
+					dword offset;
+					dword length;
+					dword size;
+					uint depth;
+					dword input;
+					dword inputLength;
+					dword inputSize;
 				};
 
-				Input input;
-				std::stringstream stream;
+				static inline byte* WriteLength(byte*,dword);
+				static inline dword ReadLength(const byte*&,const byte*);
 
-			public:
+				static byte* Encode(const byte*,dword,const byte*,dword,byte*,const byte*);
+				static void Decode(const byte*,dword,byte*,dword,bool);
+
+				void Discard(dword,dword);
+				void Store(uint,const byte*,dword,dword,uint);
+				void Restore(uint);
+
+				dword capacity;
+				dword head;
+				dword counter;
+				dword reference;
+				Buffer arena;
+				Buffer current;
+				Buffer state;
+				Block blocks[NUM_KEYS];
+			};
 
-				Key();
-				~Key();
+			class InputLog
+			{
+			public:
 
 				void Reset();
-				void BeginForward(Machine&,EmuSaveState,EmuLoadState);
-				void EndForward();
-				void BeginBackward(Machine&,EmuLoadState);
-				inline void EndBackward();
+				inline void BeginForward();
+				void EndForward(Keyframes&,uint) const;
+				inline void BeginBackward();
+				void BeginBackward(const Keyframes&,uint);
 
 				inline uint Put(uint);
 				inline uint Get();
 
-				inline bool CanRewind() const;
 				inline void ResumeForward();
-				inline void TurnForward(Machine&,EmuLoadState);
-				inline void Invalidate();
+				inline bool CanRewind() const;
+
+			private:
+
+				enum
+				{
+					BAD_POS = INT_MAX,
+					OPEN_BUS = 0x40
+				};
+
+				dword pos;
+				Buffer buffer;
 			};
 
 			class ReverseVideo
@@ -198,10 +235,11 @@ namespace Nes
 				}
 			};
 
-			inline Key* PrevKey(Key*);
-			inline Key* PrevKey();
-			inline Key* NextKey(Key*);
-			inline Key* NextKey();
+			inline uint PrevKey() const;
+			inline uint NextKey() const;
+
+			void SaveKey();
+			void LoadKey(uint);
 
 			NES_DECL_PEEK( Port_Get );
 			NES_DECL_PEEK( Port_Put );
@@ -213,8 +251,9 @@ namespace Nes
 
 			const Io::Port* ports[2];
 
-			Key* key;
-			Key keys[NUM_KEYS];
+			uint key;
+			InputLog input;
+			Keyframes keyframes;
 
 			ReverseSound sound;
 			ReverseVideo video;
@@ -42,7 +42,7 @@ namespace Nes
 
 			Renderer::Filter2xSaI::Filter2xSaI(const RenderState& state)
 			:
-			Filter (state),
+			Filter (state,2),
 			lsb0   (~((1UL << format.shifts[0]) | (1UL << format.shifts[1]) | (1UL << format.shifts[2]))),
 			lsb1   (~((3UL << format.shifts[0]) | (3UL << format.shifts[1]) | (3UL << format.shifts[2])))
 			{
@@ -76,20 +76,20 @@ namespace Nes
 			}
 
 			template<typename T>
-			void Renderer::Filter2xSaI::BlitType(const Input& input,const Output& output) const
+			void Renderer::Filter2xSaI::BlitType(const Input& input,const Output& output,const uint first,const uint count) const
 			{
-				const word* NST_RESTRICT src = input.pixels;
+				const word* NST_RESTRICT src = input.pixels + first * WIDTH;
 				const long pitch = output.pitch;
 
 				T* NST_RESTRICT dst[2] =
 				{
-					static_cast<T*>(output.pixels),
-					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + pitch)
+					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + pitch * long(first * 2)),
+					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + pitch * long(first * 2 + 1))
 				};
 
 				dword a,b,c,d,e=0,f=0,g,h,i=0,j=0,k,l,m,n,o;
 
-				for (uint y=0; y < HEIGHT; ++y)
+				for (uint y=first, end=first+count; y < end; ++y)
 				{
 					for (uint x=0; x < WIDTH; ++x, ++src, dst[0] += 2, dst[1] += 2)
 					{
@@ -252,12 +252,12 @@ namespace Nes
 				}
 			}
 
-			void Renderer::Filter2xSaI::Blit(const Input& input,const Output& output,uint)
+			void Renderer::Filter2xSaI::Blit(const Input& input,const Output& output,uint,uint first,uint count)
 			{
 				switch (format.bpp)
 				{
-					case 32: BlitType< dword >( input, output ); break;
-					case 16: BlitType< word  >( input, output ); break;
+					case 32: BlitType< dword >( input, output, first, count ); break;
+					case 16: BlitType< word  >( input, output, first, count ); break;
 					default: NST_UNREACHABLE();
 				}
 			}
@@ -45,10 +45,10 @@ namespace Nes
 
 			private:
 
-				void Blit(const Input&,const Output&,uint);
+				void Blit(const Input&,const Output&,uint,uint,uint);
 
 				template<typename T>
-				void BlitType(const Input&,const Output&) const;
+				void BlitType(const Input&,const Output&,uint,uint) const;
 
 				inline dword Blend(dword,dword) const;
 				inline dword Blend(dword,dword,dword,dword) const;
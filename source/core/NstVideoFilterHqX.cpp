@@ -31,15 +31,23 @@
 #include "NstVideoRenderer.hpp"
 #include "NstVideoFilterHqX.hpp"
 
+#ifdef NST_MM_INTRINSICS
+#if NST_MSVC
+#include <intrin.h>
+#elif NST_GCC
+#include <cpuid.h>
+#endif
+#endif
+
 namespace Nes
 {
 	namespace Core
 	{
 		namespace Video
 		{
-			void Renderer::FilterHqX::Blit(const Input& input,const Output& output,uint)
+			void Renderer::FilterHqX::Blit(const Input& input,const Output& output,uint,uint first,uint count)
 			{
-				(*this.*path)( input, output );
+				(*this.*path)( input, output, first, count );
 			}
 
 			template<dword R,dword G,dword B>
@@ -153,18 +161,18 @@ namespace Nes
 			};
 
 			template<typename T,dword R,dword G,dword B>
-			void Renderer::FilterHqX::Blit2x(const Input& input,const Output& output) const
+			void Renderer::FilterHqX::Blit2x(const Input& input,const Output& output,const uint first,const uint count) const
 			{
-				const byte* NST_RESTRICT src = reinterpret_cast<const byte*>(input.pixels);
+				const byte* NST_RESTRICT src = reinterpret_cast<const byte*>(input.pixels + first * WIDTH);
 				const long pitch = output.pitch + output.pitch - (WIDTH*2 * sizeof(T));
 
 				T* NST_RESTRICT dst[2] =
 				{
-					static_cast<T*>(output.pixels) - 2,
-					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch) - 2
+					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * long(first * 2 + 0)) - 2,
+					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * long(first * 2 + 1)) - 2
 				};
 
-				for (uint y=HEIGHT; y; --y)
+				for (uint y=HEIGHT-first, end=y-count; y != end; --y)
 				{
 					const uint lines[2] =
 					{
@@ -211,19 +219,19 @@ namespace Nes
 			}
 
 			template<typename T,dword R,dword G,dword B>
-			void Renderer::FilterHqX::Blit3x(const Input& input,const Output& output) const
+			void Renderer::FilterHqX::Blit3x(const Input& input,const Output& output,const uint first,const uint count) const
 			{
-				const byte* NST_RESTRICT src = reinterpret_cast<const byte*>(input.pixels);
+				const byte* NST_RESTRICT src = reinterpret_cast<const byte*>(input.pixels + first * WIDTH);
 				const long pitch = (output.pitch * 2) + output.pitch - (WIDTH*3 * sizeof(T));
 
 				T* NST_RESTRICT dst[3] =
 				{
-					static_cast<T*>(output.pixels) - 3,
-					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch) - 3,
-					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * 2) - 3
+					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * long(first * 3 + 0)) - 3,
+					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * long(first * 3 + 1)) - 3,
+					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * long(first * 3 + 2)) - 3
 				};
 
-				for (uint y=HEIGHT; y; --y)
+				for (uint y=HEIGHT-first, end=y-count; y != end; --y)
 				{
 					const uint lines[2] =
 					{
@@ -272,20 +280,20 @@ namespace Nes
 			}
 
 			template<typename T,dword R,dword G,dword B>
-			void Renderer::FilterHqX::Blit4x(const Input& input,const Output& output) const
+			void Renderer::FilterHqX::Blit4x(const Input& input,const Output& output,const uint first,const uint count) const
 			{
-				const byte* NST_RESTRICT src = reinterpret_cast<const byte*>(input.pixels);
+				const byte* NST_RESTRICT src = reinterpret_cast<const byte*>(input.pixels + first * WIDTH);
 				const long pitch = (output.pitch * 3) + output.pitch - (WIDTH*4 * sizeof(T));
 
 				T* NST_RESTRICT dst[4] =
 				{
-					static_cast<T*>(output.pixels) - 4,
-					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch) - 4,
-					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * 2) - 4,
-					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * 3) - 4
+					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * long(first * 4 + 0)) - 4,
+					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * long(first * 4 + 1)) - 4,
+					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * long(first * 4 + 2)) - 4,
+					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * long(first * 4 + 3)) - 4
 				};
 
-				for (uint y=HEIGHT; y; --y)
+				for (uint y=HEIGHT-first, end=y-count; y != end; --y)
 				{
 					const uint lines[2] =
 					{
@@ -335,10 +343,524 @@ namespace Nes
 				}
 			}
 
+			#ifdef NST_MM_INTRINSICS
+
+			class Renderer::FilterHqX::Rules
+			{
+			public:
+
+				explicit Rules(uint);
+				~Rules();
+
+				enum
+				{
+					KEYS = 0x1000,
+					UNIFORM = 0x1000
+				};
+
+				// two horizontally adjacent output pixels, the weights and the
+				// operands are kept as byte offsets to save the unpacking in Blend()
+
+				struct Pair
+				{
+					word weights;
+					byte operands[3][2];
+				};
+
+				const Pair* Table() const
+				{
+					return table;
+				}
+
+				NST_FORCE_INLINE __m128i Blend(const word (&c)[9][4],const Pair& pair) const
+				{
+					const byte* const NST_RESTRICT w = reinterpret_cast<const byte*>(weights) + pair.weights;
+
+					return _mm_srli_epi16
+					(
+						_mm_add_epi16
+						(
+							_mm_add_epi16
+							(
+								_mm_mullo_epi16( Operands( c, pair.operands[0] ), _mm_loadu_si128( reinterpret_cast<const __m128i*>(w + 0x00) ) ),
+								_mm_mullo_epi16( Operands( c, pair.operands[1] ), _mm_loadu_si128( reinterpret_cast<const __m128i*>(w + 0x10) ) )
+							),
+							_mm_mullo_epi16( Operands( c, pair.operands[2] ), _mm_loadu_si128( reinterpret_cast<const __m128i*>(w + 0x20) ) )
+						),
+						4
+					);
+				}
+
+			private:
+
+				static NST_FORCE_INLINE __m128i Operands(const word (&c)[9][4],const byte (&offsets)[2])
+				{
+					return _mm_unpacklo_epi64
+					(
+						_mm_loadl_epi64( reinterpret_cast<const __m128i*>(reinterpret_cast<const byte*>(c) + offsets[0]) ),
+						_mm_loadl_epi64( reinterpret_cast<const __m128i*>(reinterpret_cast<const byte*>(c) + offsets[1]) )
+					);
+				}
+
+				enum
+				{
+					NUM_WEIGHTS = 11
+				};
+
+				struct Probe
+				{
+					Probe();
+
+					uint w[9];
+					dword c[9];
+				};
+
+				struct Yuv
+				{
+					explicit Yuv(uint);
+
+					dword yuv[9];
+				};
+
+				class Edges
+				{
+					const uint key;
+
+				public:
+
+					explicit Edges(uint k)
+					: key(k) {}
+
+					bool operator () (uint,uint) const;
+				};
+
+				static dword Mix(dword,uint,dword,uint,dword=0,uint=0);
+
+				template<dword R,dword G,dword B> static dword Interpolate1(dword c1,dword c2)           { return Mix( c1, 12, c2,  4         ); }
+				template<dword R,dword G,dword B> static dword Interpolate2(dword c1,dword c2,dword c3)  { return Mix( c1,  8, c2,  4, c3,  4 ); }
+				template<dword R,dword G,dword B> static dword Interpolate3(dword c1,dword c2)           { return Mix( c1, 14, c2,  2         ); }
+				template<dword R,dword G,dword B> static dword Interpolate4(dword c1,dword c2,dword c3)  { return Mix( c1,  2, c2,  7, c3,  7 ); }
+				template<dword R,dword G,dword B> static dword Interpolate5(dword c1,dword c2)           { return Mix( c1,  8, c2,  8         ); }
+				template<dword R,dword G,dword B> static dword Interpolate6(dword c1,dword c2,dword c3)  { return Mix( c1, 10, c2,  4, c3,  2 ); }
+				template<dword R,dword G,dword B> static dword Interpolate7(dword c1,dword c2,dword c3)  { return Mix( c1, 12, c2,  2, c3,  2 ); }
+				template<dword R,dword G,dword B> static dword Interpolate8(dword c1,dword c2)           { return Mix( c1, 10, c2,  6         ); }
+				template<dword R,dword G,dword B> static dword Interpolate9(dword c1,dword c2,dword c3)  { return Mix( c1,  4, c2,  6, c3,  6 ); }
+				template<dword R,dword G,dword B> static dword Interpolate10(dword c1,dword c2,dword c3) { return Mix( c1, 14, c2,  1, c3,  1 ); }
+
+				static void Probe2x(uint,dword*);
+				static void Probe3x(uint,dword*);
+				static void Probe4x(uint,dword*);
+
+				Pair* const table;
+				word weights[NUM_WEIGHTS * NUM_WEIGHTS][3][8];
+			};
+
+			struct Renderer::FilterHqX::Line
+			{
+				dword w[WIDTH+2];
+				dword yuv[WIDTH+2];
+				word rgb[WIDTH+2][4];
+			};
+
+			inline __m128i Renderer::FilterHqX::Load(const dword* p)
+			{
+				return _mm_loadu_si128( reinterpret_cast<const __m128i*>(p) );
+			}
+
+			inline __m128i Renderer::FilterHqX::Pattern(__m128i same,__m128i yuv,const dword* neighbour,int bit)
+			{
+				return _mm_andnot_si128
+				(
+					_mm_or_si128( same, _mm_cmpeq_epi32( _mm_and_si128( _mm_sub_epi32( yuv, Load(neighbour) ), _mm_set1_epi32( Lut::YUV_MASK ) ), _mm_setzero_si128() ) ),
+					_mm_set1_epi32( bit )
+				);
+			}
+
+			inline __m128i Renderer::FilterHqX::Edge(const dword* yuv1,const dword* yuv2,int bit)
+			{
+				return _mm_andnot_si128
+				(
+					_mm_cmpeq_epi32( _mm_and_si128( _mm_add_epi32( _mm_sub_epi32( Load(yuv1), Load(yuv2) ), _mm_set1_epi32( Lut::YUV_OFFSET ) ), _mm_set1_epi32( Lut::YUV_MASK ) ), _mm_setzero_si128() ),
+					_mm_set1_epi32( bit )
+				);
+			}
+
+			void Renderer::FilterHqX::FillLine(Line& line,const Input& input,const Input::Pixel* NST_RESTRICT src) const
+			{
+				for (uint x=1; x <= WIDTH; ++x)
+				{
+					const uint w = input.palette[*src++];
+					const dword rgb = lut.rgb[w];
+
+					line.w[x] = w;
+					line.yuv[x] = lut.yuv[w];
+					line.rgb[x][0] = rgb >>  0 & 0xFF;
+					line.rgb[x][1] = rgb >>  8 & 0xFF;
+					line.rgb[x][2] = rgb >> 16 & 0xFF;
+					line.rgb[x][3] = 0;
+				}
+
+				line.w[0] = line.w[1];
+				line.yuv[0] = line.yuv[1];
+
+				line.w[WIDTH+1] = line.w[WIDTH];
+				line.yuv[WIDTH+1] = line.yuv[WIDTH];
+
+				for (uint i=0; i < 4; ++i)
+				{
+					line.rgb[0][i] = line.rgb[1][i];
+					line.rgb[WIDTH+1][i] = line.rgb[WIDTH][i];
+				}
+			}
+
+			template<uint N>
+			inline void Renderer::FilterHqX::Store(dword* NST_RESTRICT dst,__m128i pixels)
+			{
+				if (N == 4)
+				{
+					_mm_storeu_si128( reinterpret_cast<__m128i*>(dst), pixels );
+				}
+				else
+				{
+					_mm_storel_epi64( reinterpret_cast<__m128i*>(dst), pixels );
+
+					if (N == 3)
+						dst[2] = _mm_cvtsi128_si32( _mm_srli_si128( pixels, 8 ) );
+				}
+			}
+
+			template<uint N>
+			void Renderer::FilterHqX::BlitSse2(const Input& input,const Output& output,const uint first,const uint count) const
+			{
+				NST_COMPILE_ASSERT( WIDTH % 4 == 0 );
+
+				enum {PAIRS = (N * N + 1) / 2};
+
+				const Input::Pixel* NST_RESTRICT src = input.pixels + first * WIDTH;
+
+				dword* NST_RESTRICT dst[N];
+
+				for (uint i=0; i < N; ++i)
+					dst[i] = reinterpret_cast<dword*>(static_cast<byte*>(output.pixels) + output.pitch * long(first * N + i));
+
+				const long pitch = output.pitch * long(N);
+
+				Line lines[3];
+				dword keys[WIDTH];
+
+				const Rules& hq = *rules;
+				const Rules::Pair* const NST_RESTRICT table = hq.Table();
+
+				const Line* up = lines;
+				const Line* line = lines;
+
+				FillLine( lines[0], input, src );
+
+				if (first)
+				{
+					FillLine( lines[1], input, src - WIDTH );
+					up = lines + 1;
+				}
+
+				for (uint y=first, end=first+count; y != end; ++y)
+				{
+					const Line* down = line;
+
+					if (y + 1 < HEIGHT)
+					{
+						Line* const next = lines + (lines == up || lines == line ? lines+1 == up || lines+1 == line ? 2 : 1 : 0);
+						src += WIDTH;
+						FillLine( *next, input, src );
+						down = next;
+					}
+
+					for (uint x=0; x < WIDTH; x += 4)
+					{
+						const __m128i w = Load( line->w + x + 1 );
+						const __m128i yuv = Load( line->yuv + x + 1 );
+
+						const __m128i same[8] =
+						{
+							_mm_cmpeq_epi32( w, Load( up->w   + x + 0 ) ),
+							_mm_cmpeq_epi32( w, Load( up->w   + x + 1 ) ),
+							_mm_cmpeq_epi32( w, Load( up->w   + x + 2 ) ),
+							_mm_cmpeq_epi32( w, Load( line->w + x + 0 ) ),
+							_mm_cmpeq_epi32( w, Load( line->w + x + 2 ) ),
+							_mm_cmpeq_epi32( w, Load( down->w + x + 0 ) ),
+							_mm_cmpeq_epi32( w, Load( down->w + x + 1 ) ),
+							_mm_cmpeq_epi32( w, Load( down->w + x + 2 ) )
+						};
+
+						_mm_storeu_si128
+						(
+							reinterpret_cast<__m128i*>(keys + x),
+							_mm_or_si128
+							(
+								_mm_or_si128
+								(
+									_mm_or_si128
+									(
+										_mm_or_si128( Pattern( same[0], yuv, up->yuv   + x + 0, 0x01 ), Pattern( same[1], yuv, up->yuv   + x + 1, 0x02 ) ),
+										_mm_or_si128( Pattern( same[2], yuv, up->yuv   + x + 2, 0x04 ), Pattern( same[3], yuv, line->yuv + x + 0, 0x08 ) )
+									),
+									_mm_or_si128
+									(
+										_mm_or_si128( Pattern( same[4], yuv, line->yuv + x + 2, 0x10 ), Pattern( same[5], yuv, down->yuv + x + 0, 0x20 ) ),
+										_mm_or_si128( Pattern( same[6], yuv, down->yuv + x + 1, 0x40 ), Pattern( same[7], yuv, down->yuv + x + 2, 0x80 ) )
+									)
+								),
+								_mm_or_si128
+								(
+									_mm_or_si128
+									(
+										_mm_or_si128( Edge( up->yuv   + x + 1, line->yuv + x + 2, 0x100 ), Edge( line->yuv + x + 2, down->yuv + x + 1, 0x200 ) ),
+										_mm_or_si128( Edge( down->yuv + x + 1, line->yuv + x + 0, 0x400 ), Edge( line->yuv + x + 0, up->yuv   + x + 1, 0x800 ) )
+									),
+									_mm_and_si128
+									(
+										_mm_and_si128
+										(
+											_mm_and_si128( same[0], same[1] ),
+											_mm_and_si128( same[2], same[3] )
+										),
+										_mm_and_si128
+										(
+											_mm_and_si128( same[4], _mm_and_si128( same[5], same[6] ) ),
+											_mm_and_si128( same[7], _mm_set1_epi32( Rules::UNIFORM ) )
+										)
+									)
+								)
+							)
+						);
+					}
+
+					for (uint x=0; x < WIDTH; ++x)
+					{
+						if (keys[x] & Rules::UNIFORM)
+						{
+							// all neighbours share the same color, every blend will yield it unchanged
+
+							const __m128i pixels( _mm_set1_epi32( lut.rgb[line->w[x+1]] ) );
+
+							for (uint i=0; i < N; ++i)
+								Store<N>( dst[i] + x * N, pixels );
+
+							continue;
+						}
+
+						word c[9][4];
+
+						_mm_storeu_si128( reinterpret_cast<__m128i*>(c[0]), _mm_loadu_si128( reinterpret_cast<const __m128i*>(up->rgb[x]) ) );
+						_mm_storel_epi64( reinterpret_cast<__m128i*>(c[2]), _mm_loadl_epi64( reinterpret_cast<const __m128i*>(up->rgb[x+2]) ) );
+						_mm_storeu_si128( reinterpret_cast<__m128i*>(c[3]), _mm_loadu_si128( reinterpret_cast<const __m128i*>(line->rgb[x]) ) );
+						_mm_storel_epi64( reinterpret_cast<__m128i*>(c[5]), _mm_loadl_epi64( reinterpret_cast<const __m128i*>(line->rgb[x+2]) ) );
+						_mm_storeu_si128( reinterpret_cast<__m128i*>(c[6]), _mm_loadu_si128( reinterpret_cast<const __m128i*>(down->rgb[x]) ) );
+						_mm_storel_epi64( reinterpret_cast<__m128i*>(c[8]), _mm_loadl_epi64( reinterpret_cast<const __m128i*>(down->rgb[x+2]) ) );
+
+						const Rules::Pair* const NST_RESTRICT pair = table + (keys[x] & (Rules::KEYS-1)) * PAIRS;
+
+						if (N == 3)
+						{
+							// nine pixels in five blends, the rows straddle the packed vectors
+
+							const __m128i a( _mm_packus_epi16( hq.Blend( c, pair[0] ), hq.Blend( c, pair[1] ) ) );
+							const __m128i b( _mm_packus_epi16( hq.Blend( c, pair[2] ), hq.Blend( c, pair[3] ) ) );
+							const __m128i d( _mm_packus_epi16( hq.Blend( c, pair[4] ), _mm_setzero_si128() ) );
+
+							Store<N>( dst[0] + x * N, a );
+							Store<N>( dst[1] + x * N, _mm_or_si128( _mm_srli_si128( a, 12 ), _mm_slli_si128( b, 4 ) ) );
+							Store<N>( dst[2] + x * N, _mm_or_si128( _mm_srli_si128( b, 8 ), _mm_slli_si128( d, 8 ) ) );
+						}
+						else for (uint i=0; i < N; ++i)
+						{
+							Store<N>
+							(
+								dst[i] + x * N,
+								_mm_packus_epi16( hq.Blend( c, pair[i * N / 2] ), N == 4 ? hq.Blend( c, pair[i * N / 2 + 1] ) : _mm_setzero_si128() )
+							);
+						}
+					}
+
+					for (uint i=0; i < N; ++i)
+						dst[i] = reinterpret_cast<dword*>(reinterpret_cast<byte*>(dst[i]) + pitch);
+
+					up = line;
+					line = down;
+				}
+			}
+
+			#endif
+
 			#ifdef NST_MSVC_OPTIMIZE
 			#pragma optimize("s", on)
 			#endif
 
+			#ifdef NST_MM_INTRINSICS
+
+			Renderer::FilterHqX::Rules::Probe::Probe()
+			{
+				for (uint k=0; k < 9; ++k)
+				{
+					w[k] = k;
+					c[k] = k | 16U << 4;
+				}
+			}
+
+			Renderer::FilterHqX::Rules::Yuv::Yuv(const uint key)
+			{
+				for (uint k=0; k < 9; ++k)
+					yuv[k] = (k != 4 && (key & 1U << (k - (k > 4)))) ? 0U - 0x10 : 0U;
+			}
+
+			bool Renderer::FilterHqX::Rules::Edges::operator () (const uint w1,uint) const
+			{
+				// the edges are always probed in the same pairs, 1-5, 5-7, 7-3 and 3-1
+
+				switch (w1)
+				{
+					case 1: return key & 0x100;
+					case 5: return key & 0x200;
+					case 7: return key & 0x400;
+				}
+
+				NST_ASSERT( w1 == 3 );
+				return key & 0x800;
+			}
+
+			dword Renderer::FilterHqX::Rules::Mix(dword c1,uint w1,dword c2,uint w2,dword c3,uint w3)
+			{
+				return (c1 & 0xF) | w1 << 4 | ((c2 & 0xF) | w2 << 4) << 9 | ((c3 & 0xF) | w3 << 4) << 18;
+			}
+
+			void Renderer::FilterHqX::Rules::Probe2x(const uint key,dword* const entries)
+			{
+				enum {R,G,B};
+
+				const Probe b;
+				const Yuv lut( key );
+				const Edges Diff( key );
+				const uint yuv5 = 0;
+
+				dword* const NST_RESTRICT dst[2] = { entries, entries + 2 };
+
+				#include "NstVideoFilterHq2x.inl"
+			}
+
+			void Renderer::FilterHqX::Rules::Probe3x(const uint key,dword* const entries)
+			{
+				enum {R,G,B};
+
+				const Probe b;
+				const Yuv lut( key );
+				const Edges Diff( key );
+				const uint yuv5 = 0;
+
+				dword* const NST_RESTRICT dst[3] = { entries, entries + 3, entries + 6 };
+
+				#include "NstVideoFilterHq3x.inl"
+			}
+
+			void Renderer::FilterHqX::Rules::Probe4x(const uint key,dword* const entries)
+			{
+				enum {R,G,B};
+
+				const Probe b;
+				const Yuv lut( key );
+				const Edges Diff( key );
+				const uint yuv5 = 0;
+
+				dword* const NST_RESTRICT dst[4] = { entries, entries + 4, entries + 8, entries + 12 };
+
+				#include "NstVideoFilterHq4x.inl"
+			}
+
+			Renderer::FilterHqX::Rules::Rules(const uint scale)
+			: table(new Pair [KEYS * ((scale * scale + 1) / 2)])
+			{
+				static const byte sets[NUM_WEIGHTS][3] =
+				{
+					{16,0,0}, {12,4,0}, {8,4,4}, {14,2,0}, {2,7,7}, {8,8,0},
+					{10,4,2}, {12,2,2}, {10,6,0}, {4,6,6}, {14,1,1}
+				};
+
+				for (uint i=0; i < NUM_WEIGHTS * NUM_WEIGHTS; ++i)
+				{
+					for (uint j=0; j < 3; ++j)
+					{
+						for (uint k=0; k < 4; ++k)
+						{
+							weights[i][j][k+0] = sets[i / NUM_WEIGHTS][j];
+							weights[i][j][k+4] = sets[i % NUM_WEIGHTS][j];
+						}
+					}
+				}
+
+				for (uint key=0; key < KEYS; ++key)
+				{
+					dword entries[4*4];
+
+					if (scale == 2)
+						Probe2x( key, entries );
+					else if (scale == 3)
+						Probe3x( key, entries );
+					else
+						Probe4x( key, entries );
+
+					for (uint i=0; i < scale * scale; ++i)
+					{
+						const dword entry = entries[i];
+
+						uint set = 0;
+
+						while (set < NUM_WEIGHTS-1 && (sets[set][0] != (entry >> 4 & 0x1F) || sets[set][1] != (entry >> 13 & 0x1F) || sets[set][2] != (entry >> 22 & 0x1F)))
+							++set;
+
+						NST_ASSERT( sets[set][0] == (entry >> 4 & 0x1F) && sets[set][1] == (entry >> 13 & 0x1F) && sets[set][2] == (entry >> 22 & 0x1F) );
+
+						entries[i] = set | (entry & 0xF) << 8 | (entry >> 9 & 0xF) << 16 | (entry >> 18 & 0xF) << 24;
+					}
+
+					Pair* NST_RESTRICT pair = table + key * ((scale * scale + 1) / 2);
+
+					for (uint i=0; i < scale * scale; i += 2, ++pair)
+					{
+						const dword p0 = entries[i];
+						const dword p1 = entries[NST_MIN(i+1,scale*scale-1)];
+
+						pair->weights = ((p0 & 0xFF) * NUM_WEIGHTS + (p1 & 0xFF)) * sizeof(weights[0]);
+
+						for (uint j=0; j < 3; ++j)
+						{
+							pair->operands[j][0] = (p0 >> (8 + j * 8) & 0xF) * sizeof(word[4]);
+							pair->operands[j][1] = (p1 >> (8 + j * 8) & 0xF) * sizeof(word[4]);
+						}
+					}
+				}
+			}
+
+			Renderer::FilterHqX::Rules::~Rules()
+			{
+				delete [] table;
+			}
+
+			bool Renderer::FilterHqX::HasSse2()
+			{
+			#if defined(_M_X64) || defined(__x86_64__)
+				return true;
+			#elif NST_MSVC
+				int info[4];
+				__cpuid( info, 1 );
+				return info[3] & (1 << 26);
+			#elif NST_GCC
+				uint eax, ebx, ecx, edx;
+				return __get_cpuid( 1, &eax, &ebx, &ecx, &edx ) && (edx & (1U << 26));
+			#else
+				return false;
+			#endif
+			}
+
+			#endif
+
 			Renderer::FilterHqX::Lut::Lut(const bool bpp32,const byte (&formatShifts)[3],dword* tmp)
 			: rgb(tmp = (bpp32 ? new dword [0x10000] : NULL))
 			{
@@ -386,6 +908,10 @@ namespace Nes
 				{
 					if (state.bits.count == 32)
 					{
+					#ifdef NST_MM_INTRINSICS
+						if (HasSse2())
+							return &FilterHqX::BlitSse2<2>;
+					#endif
 						return &FilterHqX::Blit2x<dword,0xFF0000,0x00FF00,0x0000FF>;
 					}
 					else if (state.bits.mask.g == 0x07E0)
@@ -401,6 +927,10 @@ namespace Nes
 				{
 					if (state.bits.count == 32)
 					{
+					#ifdef NST_MM_INTRINSICS
+						if (HasSse2())
+							return &FilterHqX::BlitSse2<3>;
+					#endif
 						return &FilterHqX::Blit3x<dword,0xFF0000,0x00FF00,0x0000FF>;
 					}
 					else if (state.bits.mask.g == 0x07E0)
@@ -416,6 +946,10 @@ namespace Nes
 				{
 					if (state.bits.count == 32)
 					{
+					#ifdef NST_MM_INTRINSICS
+						if (HasSse2())
+							return &FilterHqX::BlitSse2<4>;
+					#endif
 						return &FilterHqX::Blit4x<dword,0xFF0000,0x00FF00,0x0000FF>;
 					}
 					else if (state.bits.mask.g == 0x07E0)
@@ -431,10 +965,27 @@ namespace Nes
 
 			Renderer::FilterHqX::FilterHqX(const RenderState& state)
 			:
-			Filter (state),
+			Filter (state,1),
 			path   (GetPath(state)),
 			lut    (state.bits.count == 32,format.shifts)
+			#ifdef NST_MM_INTRINSICS
+			,rules
+			(
+				state.bits.count == 32 && HasSse2() ? new Rules
+				(
+					state.filter == RenderState::FILTER_HQ2X ? 2 :
+					state.filter == RenderState::FILTER_HQ3X ? 3 : 4
+				) : NULL
+			)
+			#endif
+			{
+			}
+
+			Renderer::FilterHqX::~FilterHqX()
 			{
+			#ifdef NST_MM_INTRINSICS
+				delete rules;
+			#endif
 			}
 
 			bool Renderer::FilterHqX::Check(const RenderState& state)
@@ -30,6 +30,10 @@
 #pragma once
 #endif
 
+#ifdef NST_MM_INTRINSICS
+#include <emmintrin.h>
+#endif
+
 namespace Nes
 {
 	namespace Core
@@ -46,13 +50,13 @@ namespace Nes
 
 			private:
 
-				~FilterHqX() {}
+				~FilterHqX();
 
-				typedef void (FilterHqX::*Path)(const Input&,const Output&) const;
+				typedef void (FilterHqX::*Path)(const Input&,const Output&,uint,uint) const;
 
 				static Path GetPath(const RenderState&);
 
-				void Blit(const Input&,const Output&,uint);
+				void Blit(const Input&,const Output&,uint,uint,uint);
 				void Transform(const byte (&)[PALETTE][3],Input::Palette&) const;
 
 				template<dword R,dword G,dword B> static dword Interpolate1(dword,dword);
@@ -69,17 +73,38 @@ namespace Nes
 				inline dword Diff(uint,uint) const;
 
 				template<typename T,dword R,dword G,dword B>
-				void Blit2x(const Input&,const Output&) const;
+				void Blit2x(const Input&,const Output&,uint,uint) const;
 
 				template<typename T,dword R,dword G,dword B>
-				void Blit3x(const Input&,const Output&) const;
+				void Blit3x(const Input&,const Output&,uint,uint) const;
 
 				template<typename T,dword R,dword G,dword B>
-				void Blit4x(const Input&,const Output&) const;
+				void Blit4x(const Input&,const Output&,uint,uint) const;
 
 				template<typename T>
 				struct Buffer;
 
+				#ifdef NST_MM_INTRINSICS
+
+				class Rules;
+				struct Line;
+
+				static inline __m128i Load(const dword*);
+				static inline __m128i Pattern(__m128i,__m128i,const dword*,int);
+				static inline __m128i Edge(const dword*,const dword*,int);
+
+				template<uint N>
+				static inline void Store(dword*,__m128i);
+
+				void FillLine(Line&,const Input&,const Input::Pixel*) const;
+
+				template<uint N>
+				void BlitSse2(const Input&,const Output&,uint,uint) const;
+
+				static bool HasSse2();
+
+				#endif
+
 				struct Lut
 				{
 					Lut(bool,const byte (&)[3],dword* = NULL);
@@ -97,6 +122,9 @@ namespace Nes
 
 				const Path path;
 				const Lut lut;
+				#ifdef NST_MM_INTRINSICS
+				const Rules* const rules;
+				#endif
 			};
 		}
 	}
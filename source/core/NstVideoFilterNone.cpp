@@ -33,12 +33,12 @@ namespace Nes
 		namespace Video
 		{
 			template<typename T>
-			void Renderer::FilterNone::BlitAligned(const Input& input,const Output& output)
+			void Renderer::FilterNone::BlitAligned(const Input& input,const Output& output,const uint first,const uint count)
 			{
-				const Input::Pixel* NST_RESTRICT src = input.pixels;
-				T* NST_RESTRICT dst = static_cast<T*>(output.pixels);
+				const Input::Pixel* NST_RESTRICT src = input.pixels + first * WIDTH;
+				T* NST_RESTRICT dst = static_cast<T*>(output.pixels) + first * WIDTH;
 
-				for (uint prefetched=*src++, i=PIXELS; i; --i)
+				for (uint prefetched=*src++, i=count*WIDTH; i; --i)
 				{
 					const dword reg = input.palette[prefetched];
 					prefetched = *src++;
@@ -47,14 +47,14 @@ namespace Nes
 			}
 
 			template<typename T>
-			void Renderer::FilterNone::BlitUnaligned(const Input& input,const Output& output)
+			void Renderer::FilterNone::BlitUnaligned(const Input& input,const Output& output,const uint first,const uint count)
 			{
-				const Input::Pixel* NST_RESTRICT src = input.pixels;
-				T* NST_RESTRICT dst = static_cast<T*>(output.pixels);
+				const Input::Pixel* NST_RESTRICT src = input.pixels + first * WIDTH;
+				T* NST_RESTRICT dst = reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * long(first));
 
 				const long pad = output.pitch - WIDTH * sizeof(T);
 
-				for (uint prefetched=*src++, y=HEIGHT; y; --y)
+				for (uint prefetched=*src++, y=count; y; --y)
 				{
 					for (uint x=WIDTH; x; --x)
 					{
@@ -67,21 +67,21 @@ namespace Nes
 				}
 			}
 
-			void Renderer::FilterNone::Blit(const Input& input,const Output& output,uint)
+			void Renderer::FilterNone::Blit(const Input& input,const Output& output,uint,const uint first,const uint count)
 			{
 				if (format.bpp == 32)
 				{
 					if (output.pitch == WIDTH * sizeof(dword))
-						BlitAligned<dword>( input, output );
+						BlitAligned<dword>( input, output, first, count );
 					else
-						BlitUnaligned<dword>( input, output );
+						BlitUnaligned<dword>( input, output, first, count );
 				}
 				else
 				{
 					if (output.pitch == WIDTH * sizeof(word))
-						BlitAligned<word>( input, output );
+						BlitAligned<word>( input, output, first, count );
 					else
-						BlitUnaligned<word>( input, output );
+						BlitUnaligned<word>( input, output, first, count );
 				}
 			}
 
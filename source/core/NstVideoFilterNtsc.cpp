@@ -33,23 +33,28 @@ namespace Nes
 	{
 		namespace Video
 		{
-			void Renderer::FilterNtsc::Blit(const Input& input,const Output& output,uint phase)
+			void Renderer::FilterNtsc::Blit(const Input& input,const Output& output,uint phase,uint first,uint count)
 			{
-				(*this.*path)( input, output, phase );
+				(*this.*path)( input, output, phase, first, count );
+			}
+
+			uint Renderer::FilterNtsc::Phase(const uint phase) const
+			{
+				return phase & lut.noFieldMerging;
 			}
 
 			template<typename Pixel,uint BITS>
-			void Renderer::FilterNtsc::BlitType(const Input& input,const Output& output,uint phase) const
+			void Renderer::FilterNtsc::BlitType(const Input& input,const Output& output,uint phase,const uint first,const uint count) const
 			{
 				NST_ASSERT( phase < 3 );
 
-				const Input::Pixel* NST_RESTRICT src = input.pixels;
-				Pixel* NST_RESTRICT dst = static_cast<Pixel*>(output.pixels);
+				const Input::Pixel* NST_RESTRICT src = input.pixels + first * WIDTH;
+				Pixel* NST_RESTRICT dst = reinterpret_cast<Pixel*>(static_cast<byte*>(output.pixels) + output.pitch * long(first));
 				const long pad = output.pitch - (NTSC_WIDTH-7) * sizeof(Pixel);
 
-				phase &= lut.noFieldMerging;
+				phase = ((phase & lut.noFieldMerging) + first) % 3;
 
-				for (uint y=HEIGHT; y; --y)
+				for (uint y=count; y; --y)
 				{
 					NES_NTSC_BEGIN_ROW( &lut, phase, lut.black, lut.black, *src++ );
 
@@ -36,9 +36,9 @@ namespace Nes
 	{
 		namespace Video
 		{
-			void Renderer::FilterScaleX::Blit(const Input& input,const Output& output,uint)
+			void Renderer::FilterScaleX::Blit(const Input& input,const Output& output,uint,uint first,uint count)
 			{
-				path( input, output );
+				path( input, output, first, count );
 			}
 
 			template<typename T,int PREV,int NEXT>
@@ -196,33 +196,39 @@ namespace Nes
 			}
 
 			template<typename T>
-			void Renderer::FilterScaleX::Blit2x(const Input& input,const Output& output)
+			void Renderer::FilterScaleX::Blit2x(const Input& input,const Output& output,const uint first,const uint count)
 			{
-				const Input::Pixel* src = input.pixels;
-				T* dst = static_cast<T*>(output.pixels);
+				const Input::Pixel* src = input.pixels + first * WIDTH;
+				T* dst = reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * long(first * 2));
 				const long pad = output.pitch - long(sizeof(T) * WIDTH*2);
 
-				dst = Blit2xLine<T,0,WIDTH>( dst, src, input.palette, pad );
-
-				for (uint y=HEIGHT-2; y; --y)
-					dst = Blit2xLine<T,-WIDTH,WIDTH>( dst, src += WIDTH, input.palette, pad );
-
-				Blit2xLine<T,-WIDTH,0>( dst, src + WIDTH, input.palette, pad );
+				for (uint y=first, end=first+count; y != end; ++y, src += WIDTH)
+				{
+					if (y == 0)
+						dst = Blit2xLine<T,0,WIDTH>( dst, src, input.palette, pad );
+					else if (y < HEIGHT-1)
+						dst = Blit2xLine<T,-WIDTH,WIDTH>( dst, src, input.palette, pad );
+					else
+						dst = Blit2xLine<T,-WIDTH,0>( dst, src, input.palette, pad );
+				}
 			}
 
 			template<typename T>
-			void Renderer::FilterScaleX::Blit3x(const Input& input,const Output& output)
+			void Renderer::FilterScaleX::Blit3x(const Input& input,const Output& output,const uint first,const uint count)
 			{
-				const Input::Pixel* src = input.pixels;
-				T* dst = static_cast<T*>(output.pixels);
+				const Input::Pixel* src = input.pixels + first * WIDTH;
+				T* dst = reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * long(first * 3));
 				const long pad = output.pitch - long(sizeof(T) * WIDTH*3);
 
-				dst = Blit3xLine<T,0,WIDTH>( dst, src, input.palette, pad );
-
-				for (uint y=HEIGHT-2; y; --y)
-					dst = Blit3xLine<T,-WIDTH,WIDTH>( dst, src += WIDTH, input.palette, pad );
-
-				Blit3xLine<T,-WIDTH,0>( dst, src + WIDTH, input.palette, pad );
+				for (uint y=first, end=first+count; y != end; ++y, src += WIDTH)
+				{
+					if (y == 0)
+						dst = Blit3xLine<T,0,WIDTH>( dst, src, input.palette, pad );
+					else if (y < HEIGHT-1)
+						dst = Blit3xLine<T,-WIDTH,WIDTH>( dst, src, input.palette, pad );
+					else
+						dst = Blit3xLine<T,-WIDTH,0>( dst, src, input.palette, pad );
+				}
 			}
 
 			#ifdef NST_MSVC_OPTIMIZE
@@ -249,7 +255,7 @@ namespace Nes
 
 			Renderer::FilterScaleX::FilterScaleX(const RenderState& state)
 			:
-			Filter (state),
+			Filter (state,1),
 			path   (GetPath(state))
 			{
 			}
@@ -43,6 +43,10 @@
 #include "NstVideoFilter2xSaI.hpp"
 #endif
 
+#ifdef NST_MM_INTRINSICS
+#include <emmintrin.h>
+#endif
+
 namespace Nes
 {
 	namespace Core
@@ -496,8 +500,13 @@ namespace Nes
 				}
 			}
 
-			Renderer::Filter::Filter(const RenderState& state)
-			: format(state) {}
+			Renderer::Filter::Filter(const RenderState& state,const uint context)
+			: format(state), context(context) {}
+
+			uint Renderer::Filter::Phase(uint) const
+			{
+				return 0;
+			}
 
 			void Renderer::Filter::Transform(const byte (&src)[PALETTE][3],Input::Palette& dst) const
 			{
@@ -534,16 +543,59 @@ namespace Nes
 				mask.b = 0;
 			}
 
+			Renderer::Frame::Frame(Renderer& r)
+			: renderer(r), burstPhase(0) {}
+
+			Renderer::DirtyLines::DirtyLines()
+			: previous(NULL), pixels(NULL), pitch(0), phase(0), valid(false) {}
+
+			Renderer::DirtyLines::~DirtyLines()
+			{
+				delete [] previous;
+			}
+
+			Result Renderer::DirtyLines::Enable(const bool enable)
+			{
+				if (bool(previous) == enable)
+					return RESULT_NOP;
+
+				if (enable)
+				{
+					try
+					{
+						previous = new Input::Pixel [PIXELS];
+					}
+					catch (const std::bad_alloc&)
+					{
+						return RESULT_ERR_OUT_OF_MEMORY;
+					}
+				}
+				else
+				{
+					delete [] previous;
+					previous = NULL;
+				}
+
+				valid = false;
+
+				return RESULT_OK;
+			}
+
 			Renderer::Renderer()
-			: filter(NULL) {}
+			: filter(NULL), frame(NULL) {}
 
 			Renderer::~Renderer()
 			{
+				pipeline.Wait();
+
+				delete frame;
 				delete filter;
 			}
 
 			Result Renderer::SetState(const RenderState& renderState)
 			{
+				pipeline.Wait();
+
 				if (filter)
 				{
 					if
@@ -562,6 +614,8 @@ namespace Nes
 					filter = NULL;
 				}
 
+				dirty.Invalidate();
+
 				try
 				{
 					switch (renderState.filter)
@@ -707,6 +761,61 @@ namespace Nes
 				return RESULT_OK;
 			}
 
+			Result Renderer::SetThreads(uint count)
+			{
+				NST_COMPILE_ASSERT( uint(Api::Video::MAX_FILTER_THREADS) == uint(ThreadPool::MAX_THREADS) );
+
+				pipeline.Wait();
+
+				return threads.SetThreads( count );
+			}
+
+			Result Renderer::EnablePipelining(const bool enable)
+			{
+				if (bool(frame) == enable)
+					return RESULT_NOP;
+
+				pipeline.Wait();
+
+				if (enable)
+				{
+					try
+					{
+						frame = new Frame( *this );
+					}
+					catch (const std::bad_alloc&)
+					{
+						return RESULT_ERR_OUT_OF_MEMORY;
+					}
+
+					const Result result = pipeline.SetThreads( 1 );
+
+					if (NES_FAILED(result))
+					{
+						delete frame;
+						frame = NULL;
+					}
+
+					return result;
+				}
+				else
+				{
+					pipeline.SetThreads( 0 );
+
+					delete frame;
+					frame = NULL;
+
+					return RESULT_OK;
+				}
+			}
+
+			Result Renderer::EnableDirtyLines(const bool enable)
+			{
+				pipeline.Wait();
+
+				return dirty.Enable( enable );
+			}
+
 			Result Renderer::SetLevel(schar& type,int value,uint update)
 			{
 				if (value < -100 || value > 100)
@@ -772,6 +881,8 @@ namespace Nes
 			{
 				NST_VERIFY( state.update );
 
+				pipeline.Wait();
+
 				if (state.filter == RenderState::FILTER_NTSC)
 				{
 					RenderState renderState;
@@ -787,6 +898,7 @@ namespace Nes
 					filter->Transform( GetPalette(), input.palette );
 				}
 
+				dirty.Invalidate();
 				state.update = 0;
 			}
 
@@ -794,21 +906,232 @@ namespace Nes
 			#pragma optimize("", on)
 			#endif
 
+			void Renderer::Filter::BlitLines(const Input& input,const Output& output,const uint phase,uint first,const uint count,const byte* const lines)
+			{
+				if (!lines)
+				{
+					Blit( input, output, phase, first, count );
+					return;
+				}
+
+				for (uint last=first, end=first+count; first < end; first = last)
+				{
+					if (lines[first])
+					{
+						while (++last < end && lines[last]);
+						Blit( input, output, phase, first, last - first );
+					}
+					else
+					{
+						++last;
+					}
+				}
+			}
+
+			uint Renderer::DirtyLines::Update(const Input& input,const Output& output,const uint burstPhase,const uint context)
+			{
+				NST_ASSERT( previous );
+
+				if (!valid || pixels != output.pixels || pitch != output.pitch || phase != burstPhase)
+				{
+					valid = true;
+					pixels = output.pixels;
+					pitch = output.pitch;
+					phase = burstPhase;
+
+					std::memcpy( previous, input.pixels, PIXELS * sizeof(Input::Pixel) );
+
+					return HEIGHT;
+				}
+
+				// A changed source line invalidates every output line whose filter
+				// kernel reaches it, i.e. the filter's context lines on either side.
+
+				std::memset( lines, 0, sizeof(lines) );
+
+				uint count = 0;
+				uint marked = 0;
+
+				for (uint y=0; y < HEIGHT; ++y)
+				{
+					const Input::Pixel* const src = input.pixels + y * WIDTH;
+					Input::Pixel* const dst = previous + y * WIDTH;
+
+					if (std::memcmp( dst, src, WIDTH * sizeof(Input::Pixel) ))
+					{
+						std::memcpy( dst, src, WIDTH * sizeof(Input::Pixel) );
+
+						uint i = y > context ? y - context : 0;
+
+						if (i < marked)
+							i = marked;
+
+						for (marked = NST_MIN(y + context + 1,uint(HEIGHT)); i < marked; ++i, ++count)
+							lines[i] = true;
+					}
+				}
+
+				return count;
+			}
+
+			void Renderer::Bands::Execute(const uint band)
+			{
+				const uint first = HEIGHT * band / count;
+				filter->BlitLines( *input, *output, burstPhase, first, HEIGHT * (band + 1) / count - first, lines );
+			}
+
+			void Renderer::Frame::Execute(uint)
+			{
+				renderer.Draw( output, screen, burstPhase );
+			}
+
+			void Renderer::Draw(Output& output,const Input& input,const uint burstPhase)
+			{
+				if (Output::lockCallback( output ))
+				{
+					NST_VERIFY( std::labs(output.pitch) >= dword(state.width) << (filter->format.bpp / 16) );
+
+					if (std::labs(output.pitch) >= dword(state.width) << (filter->format.bpp / 16))
+					{
+						const byte* lines = NULL;
+						uint count = HEIGHT;
+
+						if (dirty.IsEnabled())
+						{
+							count = dirty.Update( input, output, filter->Phase(burstPhase), filter->context );
+
+							if (count < HEIGHT)
+								lines = dirty.lines;
+						}
+
+						if (count && threads.NumThreads())
+						{
+							Bands bands;
+
+							bands.filter = filter;
+							bands.input = &input;
+							bands.output = &output;
+							bands.lines = lines;
+							bands.burstPhase = burstPhase;
+							bands.count = threads.NumThreads() + 1;
+
+							threads.Run( bands, bands.count );
+						}
+						else if (count)
+						{
+							filter->BlitLines( input, output, burstPhase, 0, HEIGHT, lines );
+						}
+					}
+
+					Output::unlockCallback( output );
+				}
+			}
+
 			void Renderer::Blit(Output& output,Input& input,uint burstPhase)
 			{
+				pipeline.Wait();
+
 				if (filter)
 				{
 					if (state.update)
 						UpdateFilter( input );
 
-					if (Output::lockCallback( output ))
+					Draw( output, input, burstPhase );
+				}
+			}
+
+			void Renderer::Present(Output& output,Input& input,uint burstPhase)
+			{
+				if (frame)
+				{
+					pipeline.Wait();
+
+					if (filter)
+					{
+						if (state.update)
+							UpdateFilter( input );
+
+						std::memcpy( &frame->screen, &input, sizeof(Input) );
+						frame->output = output;
+						frame->burstPhase = burstPhase;
+
+						pipeline.Start( *frame, 1 );
+					}
+				}
+				else
+				{
+					Blit( output, input, burstPhase );
+				}
+			}
+
+			void Renderer::Reduce(const Input& input,byte* dst,const long pitch,const uint width,const uint height)
+			{
+				NST_ASSERT( dst && width && width <= WIDTH && height && height <= HEIGHT );
+
+				byte luma[PALETTE];
+
+				{
+					const PaletteEntries& colors = GetPalette();
+
+					for (uint i=0; i < PALETTE; ++i)
+						luma[i] = (colors[i][0] * 77U + colors[i][1] * 150U + colors[i][2] * 29U + 128) >> 8;
+				}
+
+				word columns[WIDTH+1];
+
+				for (uint x=0; x <= width; ++x)
+					columns[x] = x * WIDTH / width;
+
+				// Every destination pixel is the average of the box of source pixels it
+				// covers. Source lines are summed column-wise first, at most 240 * 255
+				// per column, and the sums of each box are divided out afterwards.
+
+				word sums[WIDTH];
+				byte line[WIDTH];
+
+				for (uint y=0; y < height; ++y, dst += pitch)
+				{
+					const uint top = y * HEIGHT / height;
+					const uint bottom = (y + 1) * HEIGHT / height;
+
+					std::memset( sums, 0, sizeof(sums) );
+
+					for (const Input::Pixel* NST_RESTRICT src = input.pixels + top * WIDTH, *const end = input.pixels + bottom * WIDTH; src != end; src += WIDTH)
+					{
+						for (uint x=0; x < WIDTH; ++x)
+							line[x] = luma[src[x]];
+
+					#ifdef NST_MM_INTRINSICS
+
+						const __m128i zero = _mm_setzero_si128();
+
+						for (uint x=0; x < WIDTH; x += 16)
+						{
+							const __m128i bytes = _mm_loadu_si128( reinterpret_cast<const __m128i*>(line + x) );
+							__m128i* const lo = reinterpret_cast<__m128i*>(sums + x);
+							__m128i* const hi = reinterpret_cast<__m128i*>(sums + x + 8);
+
+							_mm_storeu_si128( lo, _mm_add_epi16( _mm_loadu_si128( lo ), _mm_unpacklo_epi8( bytes, zero ) ) );
+							_mm_storeu_si128( hi, _mm_add_epi16( _mm_loadu_si128( hi ), _mm_unpackhi_epi8( bytes, zero ) ) );
+						}
+
+					#else
+
+						for (uint x=0; x < WIDTH; ++x)
+							sums[x] += line[x];
+
+					#endif
+					}
+
+					for (uint x=0; x < width; ++x)
 					{
-						NST_VERIFY( std::labs(output.pitch) >= dword(state.width) << (filter->format.bpp / 16) );
+						dword sum = 0;
 
-						if (std::labs(output.pitch) >= dword(state.width) << (filter->format.bpp / 16))
-							filter->Blit( input, output, burstPhase );
+						for (uint i=columns[x], n=columns[x+1]; i < n; ++i)
+							sum += sums[i];
 
-						Output::unlockCallback( output );
+						const dword area = (columns[x+1] - columns[x]) * (bottom - top);
+						dst[x] = (sum + area / 2) / area;
 					}
 				}
 			}
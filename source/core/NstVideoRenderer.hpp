@@ -28,6 +28,7 @@
 #include <cstdlib>
 #include "api/NstApiVideo.hpp"
 #include "NstVideoScreen.hpp"
+#include "NstThreadPool.hpp"
 
 #ifdef NST_PRAGMA_ONCE
 #pragma once
@@ -73,7 +74,12 @@ namespace Nes
 				Result SetState(const RenderState&);
 				Result GetState(RenderState&) const;
 				Result SetHue(int);
+				Result SetThreads(uint);
+				Result EnablePipelining(bool);
+				Result EnableDirtyLines(bool);
 				void Blit(Output&,Input&,uint);
+				void Present(Output&,Input&,uint);
+				void Reduce(const Input&,byte*,long,uint,uint);
 
 				Result SetDecoder(const Decoder&);
 
@@ -91,6 +97,7 @@ namespace Nes
 			private:
 
 				void UpdateFilter(Input&);
+				void Draw(Output&,const Input&,uint);
 
 				class Palette
 				{
@@ -188,16 +195,20 @@ namespace Nes
 
 				protected:
 
-					explicit Filter(const RenderState&);
+					explicit Filter(const RenderState&,uint=0);
 
 				public:
 
 					virtual ~Filter() {}
 
-					virtual void Blit(const Input&,const Output&,uint) = 0;
+					virtual void Blit(const Input&,const Output&,uint,uint,uint) = 0;
 					virtual void Transform(const byte (&)[PALETTE][3],Input::Palette&) const;
+					virtual uint Phase(uint) const;
+
+					void BlitLines(const Input&,const Output&,uint,uint,uint,const byte*);
 
 					const Format format;
+					const uint context;
 				};
 
 				struct State
@@ -232,9 +243,74 @@ namespace Nes
 
 				Result SetLevel(schar&,int,uint=State::UPDATE_PALETTE|State::UPDATE_FILTER);
 
+				class Bands : public ThreadPool::Job
+				{
+					void Execute(uint);
+
+				public:
+
+					Filter* filter;
+					const Input* input;
+					const Output* output;
+					const byte* lines;
+					uint burstPhase;
+					uint count;
+				};
+
+				class DirtyLines
+				{
+				public:
+
+					DirtyLines();
+					~DirtyLines();
+
+					Result Enable(bool);
+					uint Update(const Input&,const Output&,uint,uint);
+
+				private:
+
+					Input::Pixel* previous;
+					const void* pixels;
+					long pitch;
+					uint phase;
+					bool valid;
+
+				public:
+
+					byte lines[HEIGHT];
+
+					bool IsEnabled() const
+					{
+						return previous;
+					}
+
+					void Invalidate()
+					{
+						valid = false;
+					}
+				};
+
+				class Frame : public ThreadPool::Job
+				{
+					void Execute(uint);
+
+				public:
+
+					explicit Frame(Renderer&);
+
+					Renderer& renderer;
+					Output output;
+					uint burstPhase;
+					Input screen;
+				};
+
 				Filter* filter;
 				State state;
 				Palette palette;
+				ThreadPool threads;
+				ThreadPool pipeline;
+				Frame* frame;
+				DirtyLines dirty;
 
 			public:
 
@@ -328,6 +404,26 @@ namespace Nes
 					return state.fieldMerging & uint(State::FIELD_MERGING_USER);
 				}
 
+				uint GetThreads() const
+				{
+					return threads.NumThreads();
+				}
+
+				bool IsPipeliningEnabled() const
+				{
+					return frame;
+				}
+
+				bool AreDirtyLinesEnabled() const
+				{
+					return dirty.IsEnabled();
+				}
+
+				void Flush()
+				{
+					pipeline.Wait();
+				}
+
 				PaletteType GetPaletteType() const
 				{
 					return palette.GetType();
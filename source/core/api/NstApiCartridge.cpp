@@ -28,6 +28,7 @@
 #include "../NstChecksum.hpp"
 #include "../NstCartridge.hpp"
 #include "../NstImageDatabase.hpp"
+#include "../NstThreadPool.hpp"
 #include "../NstCartridgeInes.hpp"
 #include "NstApiMachine.hpp"
 
@@ -387,6 +388,19 @@ namespace Nes
 			return Create() ? emulator.imageDatabase->Load( baseStream, overloadStream ) : RESULT_ERR_OUT_OF_MEMORY;
 		}
 
+		Result Cartridge::Database::Load(const void* image,ulong size) throw()
+		{
+			if (image == NULL || size > 0xFFFFFFFF)
+				return RESULT_ERR_INVALID_PARAM;
+
+			return Create() ? emulator.imageDatabase->Load( image, size ) : RESULT_ERR_OUT_OF_MEMORY;
+		}
+
+		Result Cartridge::Database::Export(std::ostream& stream) const throw()
+		{
+			return emulator.imageDatabase ? emulator.imageDatabase->Export( stream ) : RESULT_ERR_NOT_READY;
+		}
+
 		void Cartridge::Database::Unload() throw()
 		{
 			if (emulator.imageDatabase)
@@ -463,6 +477,92 @@ namespace Nes
 			return RESULT_OK;
 		}
 
+		class Cartridge::Scanner : public Core::ThreadPool::Job
+		{
+			const Core::ImageDatabase* const database;
+			const Core::FavoredSystem favoredSystem;
+			const ScanOpenCallback open;
+			const ScanResultCallback done;
+			const UserData userData;
+
+			void Execute(uint index)
+			{
+				Profile profile;
+				std::istream* stream = NULL;
+				Result result = RESULT_NOP;
+
+				try
+				{
+					stream = open( userData, index );
+
+					if (stream)
+						result = Core::Cartridge::Identify( *stream, favoredSystem, database, profile );
+				}
+				catch (Result r)
+				{
+					result = r;
+				}
+				catch (const std::bad_alloc&)
+				{
+					result = RESULT_ERR_OUT_OF_MEMORY;
+				}
+				catch (...)
+				{
+					result = RESULT_ERR_GENERIC;
+				}
+
+				done( userData, index, stream, result, profile );
+			}
+
+		public:
+
+			Scanner
+			(
+				const Core::ImageDatabase* d,
+				Core::FavoredSystem f,
+				ScanOpenCallback o,
+				ScanResultCallback r,
+				UserData u
+			)
+			: database(d), favoredSystem(f), open(o), done(r), userData(u) {}
+		};
+
+		Result Cartridge::Scan(ulong count,Machine::FavoredSystem system,ScanOpenCallback open,ScanResultCallback done,UserData userData,uint threads) const throw()
+		{
+			if (!open || !done || count > UINT_MAX || threads > MAX_SCAN_THREADS)
+				return RESULT_ERR_INVALID_PARAM;
+
+			if (!count)
+				return RESULT_NOP;
+
+			try
+			{
+				Core::ThreadPool pool;
+
+				if (threads)
+				{
+					const Result result = pool.SetThreads( NST_MIN(threads,count-1) );
+
+					if (NES_FAILED(result) && result != RESULT_ERR_UNSUPPORTED)
+						return result;
+				}
+
+				Scanner scanner( emulator.imageDatabase, static_cast<Core::FavoredSystem>(system), open, done, userData );
+
+				pool.Run( scanner, count );
+			}
+			catch (const std::bad_alloc&)
+			{
+				return RESULT_ERR_OUT_OF_MEMORY;
+			}
+			catch (...)
+			{
+				return RESULT_ERR_GENERIC;
+			}
+
+			return RESULT_OK;
+		}
+
 		const Cartridge::Profile* Cartridge::GetProfile() const throw()
 		{
 			if (emulator.Is(Machine::CARTRIDGE))
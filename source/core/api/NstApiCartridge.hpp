@@ -50,6 +50,7 @@ namespace Nes
 		class Cartridge : public Base
 		{
 			struct ChooseProfileCaller;
+			class Scanner;
 
 		public:
 
@@ -994,7 +995,7 @@ namespace Nes
 				};
 
 				/**
-				* Resets and loads internal XML database.
+				* Resets and loads internal XML or compiled database.
 				*
 				* @param stream input stream
 				* @return result code
@@ -1003,6 +1004,7 @@ namespace Nes
 
 				/**
 				* Resets and loads internal <b>and</b> external XML databases.
+				* Compiled databases can't be merged, export the merged result instead.
 				*
 				* @param streamInternal input stream to internal XML database
 				* @param streamExternal input stream to external XML database
@@ -1010,6 +1012,32 @@ namespace Nes
 				*/
 				Result Load(std::istream& streamInternal,std::istream& streamExternal) throw();
 
+				/**
+				* Resets and maps a compiled database in place.
+				*
+				* The image is used directly without being copied or parsed and must
+				* stay valid and unchanged until the database is unloaded, which makes
+				* it suitable for a memory-mapped file. Compiled databases are written
+				* by Export(). Every record is bounds-checked once when mapped, and
+				* corrupt images are refused with RESULT_ERR_CORRUPT_FILE.
+				*
+				* @param image pointer to compiled database, must be 32-bit aligned
+				* @param size size of image
+				* @return result code
+				*/
+				Result Load(const void* image,ulong size) throw();
+
+				/**
+				* Saves the loaded databases in compiled form.
+				*
+				* The output can be passed back to any of the Load() methods on a
+				* system with the same byte order and wide-character size.
+				*
+				* @param stream output stream
+				* @return result code
+				*/
+				Result Export(std::ostream& stream) const throw();
+
 				/**
 				* Removes all databases from the system.
 				*/
@@ -1339,6 +1367,57 @@ namespace Nes
 			*/
 			static Result ReadUnif(std::istream& stream,Machine::FavoredSystem system,Profile& profile) throw();
 
+			enum
+			{
+				/**
+				* Maximum number of worker threads for Scan().
+				*/
+				MAX_SCAN_THREADS = 15
+			};
+
+			/**
+			* Scanner input callback prototype.
+			*
+			* Called from any of the scanning threads when an image is about to be identified.
+			*
+			* @param userData optional user data
+			* @param index index of image
+			* @return input stream to iNES or UNIF file, NULL to skip the image
+			*/
+			typedef std::istream* (NST_CALLBACK *ScanOpenCallback) (UserData userData,ulong index);
+
+			/**
+			* Scanner output callback prototype.
+			*
+			* Called from any of the scanning threads when an image has been identified,
+			* the stream returned by the input callback is passed back so that it can be closed.
+			*
+			* @param userData optional user data
+			* @param index index of image
+			* @param stream input stream of image, NULL if skipped
+			* @param result result code of identification, RESULT_NOP if skipped
+			* @param profile profile of image, only valid during the call
+			*/
+			typedef void (NST_CALLBACK *ScanResultCallback) (UserData userData,ulong index,std::istream* stream,Result result,const Profile& profile);
+
+			/**
+			* Identifies a batch of iNES and UNIF images in parallel.
+			*
+			* Each image is hashed, looked up in the database and matched to a board without
+			* loading it into the system. Only one image per thread is held in memory at a time,
+			* and the callbacks are called from any of the threads, so they must be thread-safe.
+			* Returns when all images have been processed.
+			*
+			* @param count number of images
+			* @param system preferred system in case of multiple profiles
+			* @param open input callback
+			* @param done output callback
+			* @param userData optional user data passed to the callbacks
+			* @param threads number of worker threads up to MAX_SCAN_THREADS, 0 to scan on the calling thread only
+			* @return result code
+			*/
+			Result Scan(ulong count,Machine::FavoredSystem system,ScanOpenCallback open,ScanResultCallback done,UserData userData,uint threads) const throw();
+
 			/**
 			* Returns the database interface.
 			*
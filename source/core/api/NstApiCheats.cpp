@@ -25,6 +25,7 @@
 #include <new>
 #include "../NstMachine.hpp"
 #include "../NstCheats.hpp"
+#include "../NstRamSearch.hpp"
 #include "NstApiCheats.hpp"
 #include "NstApiMachine.hpp"
 
@@ -347,9 +348,91 @@ namespace Nes
 			return emulator.cpu.GetRam();
 		}
 
+		NST_COMPILE_ASSERT
+		(
+			Cheats::SEARCH_NONE      == uint(Core::RamSearch::FILTER_NONE) &&
+			Cheats::SEARCH_EQUAL     == uint(Core::RamSearch::FILTER_EQUAL) &&
+			Cheats::SEARCH_NOT_EQUAL == uint(Core::RamSearch::FILTER_NOT_EQUAL) &&
+			Cheats::SEARCH_CHANGED   == uint(Core::RamSearch::FILTER_CHANGED) &&
+			Cheats::SEARCH_UNCHANGED == uint(Core::RamSearch::FILTER_UNCHANGED) &&
+			Cheats::SEARCH_INCREASED == uint(Core::RamSearch::FILTER_INCREASED) &&
+			Cheats::SEARCH_DECREASED == uint(Core::RamSearch::FILTER_DECREASED)
+		);
+
+		Result Cheats::BeginSearch(const bool wram) throw()
+		{
+			if (!emulator.Is(Machine::GAME,Machine::ON))
+				return RESULT_ERR_NOT_READY;
+
+			Core::RamSearch* const search = new (std::nothrow) Core::RamSearch( emulator.cpu, wram );
+
+			if (!search)
+				return RESULT_ERR_OUT_OF_MEMORY;
+
+			delete emulator.ramSearch;
+			emulator.ramSearch = search;
+
+			return RESULT_OK;
+		}
+
+		Result Cheats::EndSearch() throw()
+		{
+			if (!emulator.ramSearch)
+				return RESULT_NOP;
+
+			delete emulator.ramSearch;
+			emulator.ramSearch = NULL;
+
+			return RESULT_OK;
+		}
+
+		bool Cheats::IsSearching() const throw()
+		{
+			return emulator.ramSearch != NULL;
+		}
+
+		Result Cheats::SetFrameSearch(const SearchFilter filter,const uchar value) throw()
+		{
+			if (!emulator.ramSearch)
+				return RESULT_ERR_NOT_READY;
+
+			if (uint(filter) > SEARCH_DECREASED)
+				return RESULT_ERR_INVALID_PARAM;
+
+			emulator.ramSearch->SetFrameFilter( static_cast<Core::RamSearch::Filter>(filter), value );
+
+			return RESULT_OK;
+		}
+
+		ulong Cheats::NumSearchResults() const throw()
+		{
+			return emulator.ramSearch ? emulator.ramSearch->NumMatches() : 0;
+		}
+
+		ulong Cheats::GetSearchResults(SearchResult* const results,const ulong length) const throw()
+		{
+			if (!emulator.ramSearch || !results)
+				return 0;
+
+			return emulator.ramSearch->GetMatches( results, length < 0xFFFFFFFF ? length : 0xFFFFFFFF );
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("", on)
 		#endif
+
+		Result Cheats::Search(const SearchFilter filter,const uchar value) throw()
+		{
+			if (!emulator.ramSearch)
+				return RESULT_ERR_NOT_READY;
+
+			if (uint(filter) > SEARCH_DECREASED)
+				return RESULT_ERR_INVALID_PARAM;
+
+			emulator.ramSearch->Apply( static_cast<Core::RamSearch::Filter>(filter), value );
+
+			return RESULT_OK;
+		}
 	}
 }
 
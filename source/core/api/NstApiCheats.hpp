@@ -163,6 +163,130 @@ namespace Nes
 			*/
 			Ram GetRam() const throw();
 
+			/**
+			* RAM search filter.
+			*/
+			enum SearchFilter
+			{
+				/**
+				* No filtering, only takes a new snapshot.
+				*/
+				SEARCH_NONE,
+				/**
+				* Keeps bytes equal to a value.
+				*/
+				SEARCH_EQUAL,
+				/**
+				* Keeps bytes not equal to a value.
+				*/
+				SEARCH_NOT_EQUAL,
+				/**
+				* Keeps bytes that changed since the last snapshot.
+				*/
+				SEARCH_CHANGED,
+				/**
+				* Keeps bytes that didn't change since the last snapshot.
+				*/
+				SEARCH_UNCHANGED,
+				/**
+				* Keeps bytes that increased since the last snapshot.
+				*/
+				SEARCH_INCREASED,
+				/**
+				* Keeps bytes that decreased since the last snapshot.
+				*/
+				SEARCH_DECREASED
+			};
+
+			/**
+			* RAM search result.
+			*/
+			struct SearchResult
+			{
+				/**
+				* CPU address, $0000-$07FF for RAM or $6000-$7FFF for W-RAM.
+				*/
+				ushort address;
+				/**
+				* Value in the last snapshot.
+				*/
+				uchar value;
+				/**
+				* Value in the snapshot before.
+				*/
+				uchar previous;
+			};
+
+			/**
+			* Starts a new RAM search session.
+			*
+			* Takes a snapshot of CPU RAM and, optionally, of $6000-$7FFF as seen by the CPU. All
+			* bytes start out as candidates. Any running session is replaced. The session ends
+			* when the game is unloaded.
+			*
+			* $6000-$7FFF is read through the CPU memory map rather than from the cartridge
+			* memory itself. Active cheat codes patching that range show up in the snapshots,
+			* and boards with registers or open bus there are read like any other CPU access.
+			*
+			* @param wram true to include $6000-$7FFF
+			* @return result code
+			*/
+			Result BeginSearch(bool wram=true) throw();
+
+			/**
+			* Ends the RAM search session.
+			*
+			* @return result code
+			*/
+			Result EndSearch() throw();
+
+			/**
+			* Checks if a RAM search session is running.
+			*
+			* @return true if running
+			*/
+			bool IsSearching() const throw();
+
+			/**
+			* Narrows the candidates against memory right now.
+			*
+			* Takes a new snapshot and keeps the candidates passing the filter. Comparisons are
+			* against the previous snapshot, or against the value for SEARCH_EQUAL and SEARCH_NOT_EQUAL.
+			*
+			* @param filter filter
+			* @param value value for SEARCH_EQUAL and SEARCH_NOT_EQUAL
+			* @return result code
+			*/
+			Result Search(SearchFilter filter,uchar value=0) throw();
+
+			/**
+			* Sets a filter to be applied at the end of every emulated frame.
+			*
+			* Works like calling Search() after each frame. Frames run while rewinding
+			* backward and the frames emulated ahead for run-ahead are skipped.
+			*
+			* @param filter filter, SEARCH_NONE to stop filtering
+			* @param value value for SEARCH_EQUAL and SEARCH_NOT_EQUAL
+			* @return result code
+			*/
+			Result SetFrameSearch(SearchFilter filter,uchar value=0) throw();
+
+			/**
+			* Returns the number of remaining candidates.
+			*
+			* @return number
+			*/
+			ulong NumSearchResults() const throw();
+
+			/**
+			* Returns the remaining candidates in address order.
+			*
+			* @param results array to be filled
+			* @param length maximum number of results to return
+			* @return number of results written
+			*/
+			ulong GetSearchResults(SearchResult* results,ulong length) const throw();
+
 			/**
 			* Encodes into a Game Genie code.
 			*
@@ -50,7 +50,10 @@
 //
 // NST_MM_INTRINSICS         - For MMX/SSE compiler intrinsics support through
 //                             xmmintrin.h/emmintrin.h/mmintrin.h. Auto-defined if
-//                             compiler is Win32 MSVC and _M_IX86 is defined.
+//                             compiler is Win32 MSVC and _M_IX86 or _M_X64 is defined,
+//                             or if compiler is GCC and __SSE2__ is defined. Code paths
+//                             using SSE2 are still selected at runtime depending on the
+//                             CPU capabilities.
 //
 // NST_CALL <attribute>      - Compiler/platform specific calling convention for non-member
 //                             functions. Placed between return type and function name, e.g
@@ -102,6 +105,10 @@
 //                             this option is not worth using and Nestopia will force a
 //                             compile time error. Auto-defined if compiler is MSVC.
 //
+// NST_PROFILE               - Compiles in the hot path counters and stage timers read
+//                             through Api::Profiler. Requires native 64bit integer support.
+//                             Off by default, the instrumentation then compiles to nothing.
+//
 // Abbrevations:
 //
 // BC - Borland C++
@@ -130,5 +137,9 @@
 //
 // NST_NO_2XSAI   - 2xSaI video filter
 //
+// NST_NO_THREADS - Worker threads. Define if neither Win32 nor POSIX threads
+//                  are available on the target platform. All work will then
+//                  be done on the calling thread.
+//
 ////////////////////////////////////////////////////////////////////////////////////////
 */
@@ -22,6 +22,7 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////
 
+#include <new>
 #include "../NstMachine.hpp"
 #include "NstApiEmulator.hpp"
 
@@ -57,6 +58,44 @@ namespace Nes
 			return machine.tracker.Execute( machine, video, sound, input );
 		}
 
+		Result Emulator::ExecuteFrames(ulong count,uint flags) throw()
+		{
+			return machine.tracker.ExecuteFrames( machine, count, flags & FRAMES_STOP_ON_JAM );
+		}
+
+		Result Emulator::SetRunAhead(uint frames) throw()
+		{
+			return machine.tracker.SetRunAhead( frames );
+		}
+
+		uint Emulator::GetRunAhead() const throw()
+		{
+			return machine.tracker.GetRunAhead();
+		}
+
+		Result Emulator::EnableCodeCache(const bool enable) throw()
+		{
+			if (enable == machine.cpu.IsCodeCacheEnabled())
+				return RESULT_NOP;
+
+			try
+			{
+				machine.cpu.EnableCodeCache( enable );
+			}
+			catch (const std::bad_alloc&)
+			{
+				machine.cpu.EnableCodeCache( false );
+				return RESULT_ERR_OUT_OF_MEMORY;
+			}
+
+			return RESULT_OK;
+		}
+
+		bool Emulator::IsCodeCacheEnabled() const throw()
+		{
+			return machine.cpu.IsCodeCacheEnabled();
+		}
+
 		ulong Emulator::Frame() const throw()
 		{
 			return machine.tracker.Frame();
@@ -86,6 +86,82 @@ namespace Nes
 				Core::Input::Controllers* input
 			)   throw();
 
+			enum
+			{
+				/**
+				* Stops the batch early if the CPU has jammed.
+				*/
+				FRAMES_STOP_ON_JAM = 0x1
+			};
+
+			/**
+			* Executes a batch of frames with no video, sound or input output.
+			*
+			* Machine state and timing are kept exact. Intended for headless
+			* runs where only the end result is of interest. Returns when the
+			* batch is done. Frames queued through Input::QueueFrames() are
+			* consumed as the batch runs, the rest get no input.
+			*
+			* @param count number of frames to execute
+			* @param flags OR:ed FRAMES_ flags, default is none
+			* @return result code, RESULT_NOP if the batch was stopped early
+			*/
+			Result ExecuteFrames(ulong count,uint flags=0) throw();
+
+			enum
+			{
+				/**
+				* Maximum number of frames for run-ahead.
+				*/
+				MAX_RUN_AHEAD = 8
+			};
+
+			/**
+			* Sets the number of frames to run ahead.
+			*
+			* With run-ahead, each call to Execute() emulates the real frame with sound
+			* but without video, saves the machine state to memory, emulates the given
+			* number of frames ahead with the same input and presents the last of them,
+			* and finally restores the saved state. Only the presented frame is blitted
+			* and no sound is produced for frames ahead, so the cost is roughly frames+1
+			* times that of a plain frame. Input is polled once for every emulated frame.
+			* Run-ahead is bypassed during movie playback and recording and when the
+			* rewinder is enabled.
+			*
+			* @param frames number of frames up to MAX_RUN_AHEAD, 0 (default) to disable
+			* @return result code
+			*/
+			Result SetRunAhead(uint frames) throw();
+
+			/**
+			* Returns the number of frames to run ahead.
+			*
+			* @return number of frames, 0 if disabled
+			*/
+			uint GetRunAhead() const throw();
+
+			/**
+			* Enables or disables the CPU code cache.
+			*
+			* When enabled, the cartridge PRG-ROM is pre-decoded into instructions
+			* with their operands so that code running from ROM skips the opcode
+			* and operand fetches through the memory map. Cycle timing and all
+			* memory accesses are the same as without the cache. Code running
+			* from RAM is executed as usual. Costs four bytes of memory per byte
+			* of PRG-ROM. Disabled by default.
+			*
+			* @param enable true to enable
+			* @return result code
+			*/
+			Result EnableCodeCache(bool enable) throw();
+
+			/**
+			* Checks if the CPU code cache is enabled.
+			*
+			* @return true if enabled
+			*/
+			bool IsCodeCacheEnabled() const throw();
+
 			/**
 			* Returns the number of executed frames relative to the last machine power/reset.
 			*
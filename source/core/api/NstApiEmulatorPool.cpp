@@ -0,0 +1,250 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <new>
+#include "../NstAssert.hpp"
+#include "../NstThreadPool.hpp"
+#include "NstApiEmulatorPool.hpp"
+
+namespace Nes
+{
+	namespace Api
+	{
+		struct EmulatorPool::Pool : Core::ThreadPool::Job
+		{
+			struct Instance
+			{
+				Emulator* emulator;
+				Core::Video::Output* video;
+				Core::Sound::Output* sound;
+				Core::Input::Controllers* input;
+				Result result;
+				ulong executed;
+			};
+
+			Pool();
+			~Pool();
+
+			void Execute(uint);
+
+			Instance* instances;
+			uint size;
+			ulong count;
+			ulong frames;
+			ulong time;
+			Core::ThreadPool threads;
+		};
+
+		#ifdef NST_MSVC_OPTIMIZE
+		#pragma optimize("s", on)
+		#endif
+
+		EmulatorPool::Pool::Pool()
+		:
+		instances (NULL),
+		size      (0),
+		count     (0),
+		frames    (0),
+		time      (0)
+		{
+		}
+
+		EmulatorPool::Pool::~Pool()
+		{
+			for (uint i=0; i < size; ++i)
+				delete instances[i].emulator;
+
+			delete [] instances;
+		}
+
+		EmulatorPool::EmulatorPool()
+		: pool(*new Pool)
+		{
+		}
+
+		EmulatorPool::~EmulatorPool() throw()
+		{
+			delete &pool;
+		}
+
+		Result EmulatorPool::SetSize(const uint count) throw()
+		{
+			if (count == pool.size)
+				return RESULT_NOP;
+
+			Pool::Instance* instances = NULL;
+			uint size = pool.size;
+
+			try
+			{
+				if (count)
+				{
+					instances = new Pool::Instance [count];
+
+					for (uint i=0; i < count && i < pool.size; ++i)
+						instances[i] = pool.instances[i];
+
+					for (; size < count; ++size)
+					{
+						Pool::Instance& instance = instances[size];
+
+						instance.emulator = new Emulator;
+						instance.video = NULL;
+						instance.sound = NULL;
+						instance.input = NULL;
+						instance.result = RESULT_OK;
+						instance.executed = 0;
+					}
+				}
+			}
+			catch (const std::bad_alloc&)
+			{
+				if (instances)
+				{
+					for (uint i=pool.size; i < size; ++i)
+						delete instances[i].emulator;
+
+					delete [] instances;
+				}
+
+				return RESULT_ERR_OUT_OF_MEMORY;
+			}
+
+			for (uint i=count; i < pool.size; ++i)
+				delete pool.instances[i].emulator;
+
+			delete [] pool.instances;
+
+			pool.instances = instances;
+			pool.size = count;
+
+			return RESULT_OK;
+		}
+
+		uint EmulatorPool::Size() const throw()
+		{
+			return pool.size;
+		}
+
+		Result EmulatorPool::SetOutput
+		(
+			const uint index,
+			Core::Video::Output* const video,
+			Core::Sound::Output* const sound,
+			Core::Input::Controllers* const input
+		)   throw()
+		{
+			if (index >= pool.size)
+				return RESULT_ERR_INVALID_PARAM;
+
+			Pool::Instance& instance = pool.instances[index];
+
+			instance.video = video;
+			instance.sound = sound;
+			instance.input = input;
+
+			return RESULT_OK;
+		}
+
+		Result EmulatorPool::SetThreads(uint count) throw()
+		{
+			return pool.threads.SetThreads( count );
+		}
+
+		uint EmulatorPool::GetThreads() const throw()
+		{
+			return pool.threads.NumThreads();
+		}
+
+		Result EmulatorPool::GetResult(uint index) const throw()
+		{
+			return index < pool.size ? pool.instances[index].result : RESULT_ERR_INVALID_PARAM;
+		}
+
+		ulong EmulatorPool::GetFrames() const throw()
+		{
+			return pool.frames;
+		}
+
+		ulong EmulatorPool::GetFramesPerSecond() const throw()
+		{
+			return pool.time ? ulong(pool.frames * 1000.0 / pool.time) : 0;
+		}
+
+		void EmulatorPool::ResetStatistics() throw()
+		{
+			pool.frames = 0;
+			pool.time = 0;
+		}
+
+		#ifdef NST_MSVC_OPTIMIZE
+		#pragma optimize("", on)
+		#endif
+
+		void EmulatorPool::Pool::Execute(const uint index)
+		{
+			Instance& instance = instances[index];
+
+			instance.result = RESULT_OK;
+
+			for (instance.executed = 0; instance.executed < count; ++instance.executed)
+			{
+				instance.result = instance.emulator->Execute( instance.video, instance.sound, instance.input );
+
+				if (NES_FAILED(instance.result))
+					break;
+			}
+		}
+
+		Result EmulatorPool::Execute(const ulong count) throw()
+		{
+			if (!count || !pool.size)
+				return RESULT_NOP;
+
+			const ulong start = Core::ThreadPool::Milliseconds();
+
+			// each instance runs all its frames as one task so that
+			// they never have to wait for one another in between
+
+			pool.count = count;
+			pool.threads.Run( pool, pool.size );
+
+			ulong executed = 0;
+
+			for (uint i=0; i < pool.size; ++i)
+				executed += pool.instances[i].executed;
+
+			pool.frames += executed;
+			pool.time += ulong(Core::ThreadPool::Milliseconds() - start);
+
+			return executed ? RESULT_OK : RESULT_NOP;
+		}
+
+		Emulator& EmulatorPool::operator [] (uint index) const throw()
+		{
+			NST_ASSERT( index < pool.size );
+			return *pool.instances[index].emulator;
+		}
+	}
+}
@@ -0,0 +1,205 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NST_API_EMULATORPOOL_H
+#define NST_API_EMULATORPOOL_H
+
+#ifndef NST_API_EMULATOR_H
+#include "NstApiEmulator.hpp"
+#endif
+
+#ifdef NST_PRAGMA_ONCE
+#pragma once
+#endif
+
+#if NST_MSVC >= 1200
+#pragma warning( push )
+#endif
+
+namespace Nes
+{
+	namespace Api
+	{
+		/**
+		* Set of emulator instances stepped in parallel.
+		*
+		* Every instance is a complete Emulator object with its own machine state and
+		* output contexts. Loading, configuration and state handling are done on the
+		* instances as usual through the regular interfaces, e.g. Machine(pool[i]).Load().
+		* Execute() then hands each instance to whichever worker thread is idle, which
+		* runs all of its frames before picking up the next one.
+		*
+		* Per-instance surface and sound callbacks are set through Video::Output::lockFunction
+		* and Sound::Output::lockFunction. The following state is shared by all instances
+		* in the process and must be set up before the first call to Execute() and left
+		* untouched while it's running:
+		*
+		* - the FDS BIOS, Fds::SetBIOS()
+		* - the controller poll callbacks, Input::Controllers::Pad::callback and the like
+		* - the log and event callbacks, User::logCallback, User::eventCallback and the
+		*   event callbacks of Machine, Fds, Nsf, Movie, Rewinder and TapeRecorder
+		* - the question, profile and disk callbacks, User::questionCallback,
+		*   Cartridge::chooseProfileCallback, Fds::diskCallback and Fds::driveCallback
+		* - the static lock callbacks, Video::Output::lockCallback, Sound::Output::lockCallback
+		*   and their unlock counterparts
+		*
+		* These callbacks are invoked from whichever worker thread steps the instance,
+		* concurrently and without telling which instance they belong to, so they must be
+		* thread-safe and keep any per-instance data of their own.
+		*/
+		class EmulatorPool
+		{
+		public:
+
+			EmulatorPool();
+			~EmulatorPool() throw();
+
+			enum
+			{
+				/**
+				* Maximum number of worker threads.
+				*/
+				MAX_THREADS = 15
+			};
+
+			/**
+			* Sets the number of emulator instances.
+			*
+			* Existing instances are kept, instances beyond the new count are destroyed.
+			*
+			* @param count number of instances
+			* @return result code
+			*/
+			Result SetSize(uint count) throw();
+
+			/**
+			* Returns the number of emulator instances.
+			*
+			* @return number
+			*/
+			uint Size() const throw();
+
+			/**
+			* Sets the output contexts of an instance.
+			*
+			* The objects must stay valid for as long as they're assigned.
+			*
+			* @param index instance index
+			* @param video video context object or NULL to skip output
+			* @param sound sound context object or NULL to skip output
+			* @param input input context object or NULL to skip output
+			* @return result code
+			*/
+			Result SetOutput
+			(
+				uint index,
+				Core::Video::Output* video,
+				Core::Sound::Output* sound,
+				Core::Input::Controllers* input
+			)   throw();
+
+			/**
+			* Sets the number of worker threads.
+			*
+			* The calling thread always takes part in the work.
+			*
+			* @param count number of worker threads up to MAX_THREADS, 0 (default) to run on the calling thread only
+			* @return result code
+			*/
+			Result SetThreads(uint count) throw();
+
+			/**
+			* Returns the number of worker threads.
+			*
+			* @return number of worker threads
+			*/
+			uint GetThreads() const throw();
+
+			/**
+			* Executes frames on all instances.
+			*
+			* Each instance is stepped the given number of frames as one task, so instances
+			* never wait for each other between frames and idle threads pick up the next
+			* pending instance. At most as many threads as there are instances are kept
+			* busy. Returns when all instances are done. An instance failing to execute
+			* stops there for the rest of the call.
+			*
+			* @param frames number of frames per instance
+			* @return result code, RESULT_NOP if no instance could execute
+			*/
+			Result Execute(ulong frames=1) throw();
+
+			/**
+			* Returns the result of the last frame executed by an instance.
+			*
+			* @param index instance index
+			* @return result code
+			*/
+			Result GetResult(uint index) const throw();
+
+			/**
+			* Returns the total number of frames executed by all instances.
+			*
+			* @return number
+			*/
+			ulong GetFrames() const throw();
+
+			/**
+			* Returns the aggregate number of frames executed per second.
+			*
+			* Counts the time spent inside Execute() only.
+			*
+			* @return frames per second
+			*/
+			ulong GetFramesPerSecond() const throw();
+
+			/**
+			* Resets the frame and time counters.
+			*/
+			void ResetStatistics() throw();
+
+		private:
+
+			struct Pool;
+
+			Pool& pool;
+
+		public:
+
+			/**
+			* Returns an emulator instance.
+			*
+			* @param index instance index, must be less than Size()
+			* @return emulator instance
+			*/
+			Emulator& operator [] (uint index) const throw();
+		};
+	}
+}
+
+#if NST_MSVC >= 1200
+#pragma warning( pop )
+#endif
+
+#endif
@@ -224,6 +224,19 @@ namespace Nes
 			return emulator.Is(Machine::DISK) && static_cast<const Core::Fds*>(emulator.image)->HasHeader();
 		}
 
+		Result Fds::EnableFastLoad(bool state) throw()
+		{
+			if (emulator.Is(Machine::DISK) && !emulator.tracker.IsLocked())
+				return emulator.tracker.TryResync( static_cast<Core::Fds*>(emulator.image)->EnableFastLoad( state ) );
+
+			return RESULT_ERR_NOT_READY;
+		}
+
+		bool Fds::IsFastLoadEnabled() const throw()
+		{
+			return emulator.Is(Machine::DISK) && static_cast<const Core::Fds*>(emulator.image)->IsFastLoadEnabled();
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("", on)
 		#endif
@@ -164,6 +164,28 @@ namespace Nes
 			*/
 			bool HasHeader() const throw();
 
+			/**
+			* Enables or disables fast disk loading.
+			*
+			* Motor spin-up, rewinding and the gaps between blocks are cut short, and
+			* each byte read is delivered as soon as the previous one has been taken
+			* instead of at the disk's rate. Writing keeps its real timing. Loading
+			* times are greatly reduced, but timing-sensitive software may behave
+			* differently, hence it's off by default. The setting applies to the
+			* currently loaded image and is stored in its save states.
+			*
+			* @param state true to enable, false (default) to disable
+			* @return result code
+			*/
+			Result EnableFastLoad(bool state) throw();
+
+			/**
+			* Checks if fast disk loading is enabled.
+			*
+			* @return true if enabled
+			*/
+			bool IsFastLoadEnabled() const throw();
+
 			/**
 			* Disk data context.
 			*/
@@ -158,7 +158,7 @@ namespace Nes
 						case PAD3:
 						case PAD4:
 
-							old = new (std::nothrow) Core::Input::Pad( emulator.cpu, uint(type) - PAD1 );
+							old = new (std::nothrow) Core::Input::Pad( emulator.cpu, uint(type) - PAD1, emulator.mic );
 							break;
 
 						case ZAPPER:
@@ -247,7 +247,7 @@ namespace Nes
 							case PAD3:
 							case PAD4:
 
-								if (NULL != (old = new (std::nothrow) Core::Input::Pad( emulator.cpu, uint(type) - PAD1 )))
+								if (NULL != (old = new (std::nothrow) Core::Input::Pad( emulator.cpu, uint(type) - PAD1, emulator.mic )))
 								{
 									old = &emulator.extPort->Connect( port, *old );
 								}
@@ -276,7 +276,7 @@ namespace Nes
 								Core::Input::Device* const devices[2] =
 								{
 									new (std::nothrow) Core::Input::Device( emulator.cpu ),
-									new (std::nothrow) Core::Input::Pad( emulator.cpu, uint(type) - PAD1 )
+									new (std::nothrow) Core::Input::Pad( emulator.cpu, uint(type) - PAD1, emulator.mic )
 								};
 
 								Core::Input::Adapter* adapter;
@@ -445,6 +445,24 @@ namespace Nes
 
 			return false;
 		}
+
+		Result Input::QueueFrames(Controllers* const frames,const ulong count) throw()
+		{
+			if (count && !frames)
+				return RESULT_ERR_INVALID_PARAM;
+
+			if (!count && !emulator.tracker.NumQueuedInput())
+				return RESULT_NOP;
+
+			emulator.tracker.QueueInput( frames, count );
+
+			return RESULT_OK;
+		}
+
+		ulong Input::NumQueuedFrames() const throw()
+		{
+			return emulator.tracker.NumQueuedInput();
+		}
 	}
 
 	#ifdef NST_MSVC_OPTIMIZE
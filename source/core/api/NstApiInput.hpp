@@ -935,6 +935,30 @@ namespace Nes
 			*/
 			bool IsControllerConnected(Type type) const throw();
 
+			/**
+			* Queues controller states for upcoming frames.
+			*
+			* Each frame executed through Emulator::Execute() or Emulator::ExecuteFrames()
+			* takes the next element of the array as its input context, in place of the one
+			* passed to Execute(). A whole script of frames can then run in one call to
+			* ExecuteFrames() without returning to the application in between. Poll callbacks
+			* that are set are still invoked with the queued states. The array isn't copied
+			* and must stay valid until all of its frames are executed or the queue is
+			* cleared. Replaces any frames still in the queue.
+			*
+			* @param frames array of controller states, one element per frame
+			* @param count number of elements, 0 to clear the queue
+			* @return result code
+			*/
+			Result QueueFrames(Controllers* frames,ulong count) throw();
+
+			/**
+			* Returns the number of queued frames not yet executed.
+			*
+			* @return number
+			*/
+			ulong NumQueuedFrames() const throw();
+
 			/**
 			* Controller event callback prototype.
 			*
@@ -269,8 +269,86 @@ namespace Nes
 			return RESULT_OK;
 		}
 
+		ulong Machine::GetStateSize() const throw()
+		{
+			if (!Is(GAME,ON))
+				return 0;
+
+			try
+			{
+				Core::State::Saver saver( NULL, 0xFFFFFFFF );
+				emulator.SaveState( saver );
+				return saver.Size();
+			}
+			catch (...)
+			{
+				return 0;
+			}
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("", on)
 		#endif
+
+		Result Machine::LoadState(const void* mem,ulong size) throw()
+		{
+			if (!mem || !size)
+				return RESULT_ERR_INVALID_PARAM;
+
+			if (!Is(GAME,ON) || IsLocked())
+				return RESULT_ERR_NOT_READY;
+
+			try
+			{
+				emulator.tracker.Resync();
+				Core::State::Loader loader( static_cast<const byte*>(mem), size <= 0xFFFFFFFF ? size : 0xFFFFFFFF, true );
+
+				if (emulator.LoadState( loader, true ))
+					return RESULT_OK;
+				else
+					return RESULT_ERR_INVALID_CRC;
+			}
+			catch (Result result)
+			{
+				return result;
+			}
+			catch (const std::bad_alloc&)
+			{
+				return RESULT_ERR_OUT_OF_MEMORY;
+			}
+			catch (...)
+			{
+				return RESULT_ERR_GENERIC;
+			}
+		}
+
+		Result Machine::SaveState(void* mem,ulong size) const throw()
+		{
+			if (!mem || !size)
+				return RESULT_ERR_INVALID_PARAM;
+
+			if (!Is(GAME,ON))
+				return RESULT_ERR_NOT_READY;
+
+			try
+			{
+				Core::State::Saver saver( static_cast<byte*>(mem), size <= 0xFFFFFFFF ? size : 0xFFFFFFFF );
+				emulator.SaveState( saver );
+			}
+			catch (Result result)
+			{
+				return result;
+			}
+			catch (const std::bad_alloc&)
+			{
+				return RESULT_ERR_OUT_OF_MEMORY;
+			}
+			catch (...)
+			{
+				return RESULT_ERR_GENERIC;
+			}
+
+			return RESULT_OK;
+		}
 	}
 }
@@ -310,6 +310,39 @@ namespace Nes
 			*/
 			Result SaveState(std::ostream& stream,Compression compression=USE_COMPRESSION) const throw();
 
+			/**
+			* Loads a state from memory.
+			*
+			* Counterpart of SaveState(void*,ulong) const. Any data stored after the state is ignored.
+			*
+			* @param mem memory containing the state
+			* @param size size of the memory block in bytes
+			* @return result code
+			*/
+			Result LoadState(const void* mem,ulong size) throw();
+
+			/**
+			* Saves a state to memory.
+			*
+			* The state is written directly into the caller's buffer with no compression and no
+			* stream objects involved, making it suitable for per-frame snapshots. Its layout is the
+			* same as a state saved with NO_COMPRESSION, so it may also be loaded from a stream.
+			*
+			* @param mem destination memory
+			* @param size size of the memory block in bytes, must be at least GetStateSize()
+			* @return result code, RESULT_ERR_OUT_OF_MEMORY if the memory block is too small
+			*/
+			Result SaveState(void* mem,ulong size) const throw();
+
+			/**
+			* Returns the number of bytes written by SaveState(void*,ulong) const.
+			*
+			* The size normally only changes when a different game is loaded.
+			*
+			* @return size in bytes or 0 if no game is running
+			*/
+			ulong GetStateSize() const throw();
+
 			/**
 			* Returns a machine state.
 			*
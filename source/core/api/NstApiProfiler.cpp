@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "../NstMachine.hpp"
+#include "NstApiProfiler.hpp"
+
+namespace Nes
+{
+	namespace Api
+	{
+	#ifdef NST_PROFILE
+
+		NST_COMPILE_ASSERT
+		(
+			Profiler::NUM_COUNTERS == uint(Core::Profiler::NUM_COUNTERS) &&
+			Profiler::NUM_STAGES == uint(Core::Profiler::NUM_STAGES) &&
+			Profiler::COUNTER_BANK_SWAPS == uint(Core::Profiler::BANK_SWAPS) &&
+			Profiler::STAGE_VIDEO == uint(Core::Profiler::STAGE_VIDEO)
+		);
+
+		static void Convert(const Core::Profiler::Sample& sample,const qword frames,Profiler::Frame& frame)
+		{
+			const qword frequency = Core::Profiler::Frequency();
+
+			for (uint i=0; i < Profiler::NUM_COUNTERS; ++i)
+				frame.counters[i] = ulong(sample.counters[i] / frames);
+
+			for (uint i=0; i < Profiler::NUM_STAGES; ++i)
+				frame.nanoseconds[i] = ulong(sample.ticks[i] / frames * 1000000000 / frequency);
+		}
+
+	#endif
+
+		#ifdef NST_MSVC_OPTIMIZE
+		#pragma optimize("s", on)
+		#endif
+
+		bool Profiler::IsSupported() throw()
+		{
+		#ifdef NST_PROFILE
+			return true;
+		#else
+			return false;
+		#endif
+		}
+
+		Result Profiler::GetLastFrame(Frame& frame) const throw()
+		{
+		#ifdef NST_PROFILE
+			if (!emulator.profiler.NumFrames())
+				return RESULT_ERR_NOT_READY;
+
+			Convert( emulator.profiler.GetLast(), 1, frame );
+			return RESULT_OK;
+		#else
+			frame = Frame();
+			return RESULT_ERR_UNSUPPORTED;
+		#endif
+		}
+
+		Result Profiler::GetAverage(Frame& frame) const throw()
+		{
+		#ifdef NST_PROFILE
+			if (!emulator.profiler.NumFrames())
+				return RESULT_ERR_NOT_READY;
+
+			Convert( emulator.profiler.GetTotal(), emulator.profiler.NumFrames(), frame );
+			return RESULT_OK;
+		#else
+			frame = Frame();
+			return RESULT_ERR_UNSUPPORTED;
+		#endif
+		}
+
+		ulong Profiler::GetFrames() const throw()
+		{
+		#ifdef NST_PROFILE
+			return ulong(emulator.profiler.NumFrames());
+		#else
+			return 0;
+		#endif
+		}
+
+		Result Profiler::Reset() throw()
+		{
+		#ifdef NST_PROFILE
+			emulator.profiler.Reset();
+			return RESULT_OK;
+		#else
+			return RESULT_ERR_UNSUPPORTED;
+		#endif
+		}
+
+		#ifdef NST_MSVC_OPTIMIZE
+		#pragma optimize("", on)
+		#endif
+	}
+}
@@ -0,0 +1,205 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NST_API_PROFILER_H
+#define NST_API_PROFILER_H
+
+#include "NstApi.hpp"
+
+#ifdef NST_PRAGMA_ONCE
+#pragma once
+#endif
+
+#if NST_ICC >= 810
+#pragma warning( push )
+#pragma warning( disable : 444 )
+#elif NST_MSVC >= 1200
+#pragma warning( push )
+#pragma warning( disable : 4512 )
+#endif
+
+namespace Nes
+{
+	namespace Api
+	{
+		/**
+		* Profiler interface.
+		*
+		* Hot path counters and per-stage wall time, collected on every executed frame.
+		* Only available if the core was compiled with NST_PROFILE defined, otherwise
+		* all counting is compiled out and every method fails with RESULT_ERR_UNSUPPORTED.
+		*
+		* Counters are kept per thread and only the emulating thread is measured. Work
+		* handed off to other threads, i.e. filter bands run by the threads set through
+		* Video::SetFilterThreads() and frames filtered in the background when
+		* Video::EnablePipelining() is on, isn't attributed to any stage.
+		*/
+		class Profiler : public Base
+		{
+		public:
+
+			/**
+			* Interface constructor.
+			*
+			* @param instance emulator instance
+			*/
+			template<typename T>
+			Profiler(T& instance)
+			: Base(instance) {}
+
+			/**
+			* Counter.
+			*/
+			enum Counter
+			{
+				/**
+				* CPU instructions executed.
+				*/
+				COUNTER_INSTRUCTIONS,
+				/**
+				* PPU catch-up calls.
+				*/
+				COUNTER_PPU_SYNCS,
+				/**
+				* APU samples generated.
+				*/
+				COUNTER_APU_SAMPLES,
+				/**
+				* CPU hook and event invocations.
+				*/
+				COUNTER_HOOKS,
+				/**
+				* Memory bank swaps.
+				*/
+				COUNTER_BANK_SWAPS,
+				/**
+				* Number of counters.
+				*/
+				NUM_COUNTERS
+			};
+
+			/**
+			* Stage.
+			*
+			* Time spent in a nested stage isn't included in the stage it was entered from.
+			*/
+			enum Stage
+			{
+				/**
+				* Anything not covered by the other stages, e.g. input and mapper frame work.
+				*/
+				STAGE_OTHER,
+				/**
+				* CPU emulation, including memory mapped I/O not covered below.
+				*/
+				STAGE_CPU,
+				/**
+				* PPU catch-up.
+				*/
+				STAGE_PPU,
+				/**
+				* APU catch-up and sound output.
+				*/
+				STAGE_APU,
+				/**
+				* End of frame hooks and scheduled events. Hooks executed per instruction are included in STAGE_CPU.
+				*/
+				STAGE_HOOKS,
+				/**
+				* Per-frame cheat code setup. Reads and writes of patched addresses are included in STAGE_CPU.
+				*/
+				STAGE_CHEATS,
+				/**
+				* Video filtering and output done on the emulating thread, including any wait for filter threads.
+				*/
+				STAGE_VIDEO,
+				/**
+				* Number of stages.
+				*/
+				NUM_STAGES
+			};
+
+			/**
+			* Profiling data of a frame.
+			*/
+			struct Frame
+			{
+				/**
+				* Counter values, indexed by Counter.
+				*/
+				ulong counters[NUM_COUNTERS];
+
+				/**
+				* Wall time in nanoseconds, indexed by Stage.
+				*/
+				ulong nanoseconds[NUM_STAGES];
+			};
+
+			/**
+			* Checks if the core was compiled with profiling support.
+			*
+			* @return true if supported
+			*/
+			static bool IsSupported() throw();
+
+			/**
+			* Returns the profiling data of the last executed frame.
+			*
+			* If the last call executed a batch of frames, the per-frame average of that batch is returned.
+			*
+			* @param frame object to be filled
+			* @return result code, RESULT_ERR_NOT_READY if no frame has been executed yet
+			*/
+			Result GetLastFrame(Frame& frame) const throw();
+
+			/**
+			* Returns the average profiling data per frame since the last reset.
+			*
+			* @param frame object to be filled
+			* @return result code, RESULT_ERR_NOT_READY if no frame has been executed yet
+			*/
+			Result GetAverage(Frame& frame) const throw();
+
+			/**
+			* Returns the number of frames profiled since the last reset.
+			*
+			* @return number of frames
+			*/
+			ulong GetFrames() const throw();
+
+			/**
+			* Resets the collected data.
+			*
+			* @return result code
+			*/
+			Result Reset() throw();
+		};
+	}
+}
+
+#if NST_MSVC >= 1200 || NST_ICC >= 810
+#pragma warning( pop )
+#endif
+
+#endif
@@ -72,6 +72,19 @@ namespace Nes
 			emulator.tracker.EnableRewinderSound( enable );
 		}
 
+		Result Rewinder::SetMemoryLimit(ulong size) throw()
+		{
+			if (size > 0xFFFFFFFF)
+				return RESULT_ERR_INVALID_PARAM;
+
+			return emulator.tracker.SetRewinderMemory( size );
+		}
+
+		ulong Rewinder::GetMemoryLimit() const throw()
+		{
+			return emulator.tracker.GetRewinderMemory();
+		}
+
 		Rewinder::Direction Rewinder::GetDirection() const throw()
 		{
 			return emulator.tracker.IsRewinding() ? BACKWARD : FORWARD;
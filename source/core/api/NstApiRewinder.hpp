@@ -110,6 +110,38 @@ namespace Nes
 			*/
 			bool IsSoundEnabled() const throw();
 
+			enum
+			{
+				/**
+				* Default amount of memory reserved for rewind history.
+				*/
+				DEFAULT_MEMORY_LIMIT = 0x400000,
+				/**
+				* Smallest amount of memory accepted by SetMemoryLimit().
+				*/
+				MIN_MEMORY_LIMIT = 0x10000
+			};
+
+			/**
+			* Sets the amount of memory reserved for rewind history.
+			*
+			* Keyframes are stored as compressed deltas in a single preallocated buffer
+			* of this size, along with the controller input recorded between them. Once
+			* it fills up, the oldest keyframes are discarded. Changing the size resets
+			* the rewinder.
+			*
+			* @param size size in bytes, at least MIN_MEMORY_LIMIT
+			* @return result code
+			*/
+			Result SetMemoryLimit(ulong size) throw();
+
+			/**
+			* Returns the amount of memory reserved for rewind history.
+			*
+			* @return size in bytes
+			*/
+			ulong GetMemoryLimit() const throw();
+
 			/**
 			* Sets direction.
 			*
@@ -82,6 +82,11 @@ namespace Nes
 			emulator.cpu.GetApu().SetAutoTranspose( enable );
 		}
 
+		void Sound::SetBandLimited(bool enable) throw()
+		{
+			emulator.cpu.GetApu().SetBandLimited( enable );
+		}
+
 		void Sound::SetSpeaker(Speaker speaker) throw()
 		{
 			emulator.cpu.GetApu().EnableStereo( speaker == SPEAKER_STEREO );
@@ -127,6 +132,11 @@ namespace Nes
 			return emulator.cpu.GetApu().IsAutoTransposing();
 		}
 
+		bool Sound::IsBandLimited() const throw()
+		{
+			return emulator.cpu.GetApu().IsBandLimited();
+		}
+
 		Sound::Speaker Sound::GetSpeaker() const throw()
 		{
 			return emulator.cpu.GetApu().InStereo() ? SPEAKER_STEREO : SPEAKER_MONO;
@@ -85,6 +85,9 @@ namespace Nes
 					samples[1] = s1;
 					length[0] = l0;
 					length[1] = l1;
+					lockFunction = 0;
+					unlockFunction = 0;
+					userData = 0;
 				}
 
 				/**
@@ -109,6 +112,26 @@ namespace Nes
 				*/
 				typedef void (NST_CALLBACK *UnlockCallback) (void* userData,Output& output);
 
+				/**
+				* Per-output lock callback.
+				*
+				* Called instead of the static lockCallback if set. Lets emulator
+				* instances running side by side each keep their own callback.
+				*/
+				LockCallback lockFunction;
+
+				/**
+				* Per-output unlock callback.
+				*
+				* Called instead of the static unlockCallback if set.
+				*/
+				UnlockCallback unlockFunction;
+
+				/**
+				* Optional user data passed to the per-output callbacks.
+				*/
+				void* userData;
+
 				/**
 				* Sound lock callback manager.
 				*
@@ -133,7 +156,7 @@ namespace Nes
 			{
 				bool operator () (Output& output) const
 				{
-					return (!function || function( userdata, output ));
+					return (output.lockFunction ? output.lockFunction( output.userData, output ) : (!function || function( userdata, output )));
 				}
 			};
 
@@ -146,7 +169,9 @@ namespace Nes
 			{
 				void operator () (Output& output) const
 				{
-					if (function)
+					if (output.unlockFunction)
+						output.unlockFunction( output.userData, output );
+					else if (function)
 						function( userdata, output );
 				}
 			};
@@ -262,7 +287,7 @@ namespace Nes
 			/**
 			* Sets the sample rate.
 			*
-			* @param rate value in the range 11025 to 96000, default is 44100
+			* @param rate value in the range 11025 to 192000, default is 44100
 			* @return result code
 			*/
 			Result SetSampleRate(ulong rate) throw();
@@ -363,6 +388,26 @@ namespace Nes
 			*/
 			bool IsAutoTransposing() const throw();
 
+			/**
+			* Enables band-limited synthesis of the built-in sound channels.
+			*
+			* The channels are then stepped from one amplitude change to the next and
+			* every change is mixed in as a band-limited step, rather than sampling the
+			* oscillators once per output sample. The work follows the music instead of
+			* the sample rate, which makes high sample rates cheaper and free of aliasing.
+			* Expansion sound chips are unaffected. Disabled by default.
+			*
+			* @param state true to enable
+			*/
+			void SetBandLimited(bool state) throw();
+
+			/**
+			* Checks if band-limited synthesis is enabled.
+			*
+			* @return true if enabled
+			*/
+			bool IsBandLimited() const throw();
+
 			/**
 			* Checks if sound is audible at all.
 			*
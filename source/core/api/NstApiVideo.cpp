@@ -163,6 +163,36 @@ namespace Nes
 			return emulator.renderer.IsFieldMergingEnabled();
 		}
 
+		Result Video::SetFilterThreads(uint count) throw()
+		{
+			return emulator.renderer.SetThreads( count );
+		}
+
+		uint Video::GetFilterThreads() const throw()
+		{
+			return emulator.renderer.GetThreads();
+		}
+
+		Result Video::EnablePipelining(bool state) throw()
+		{
+			return emulator.renderer.EnablePipelining( state );
+		}
+
+		bool Video::IsPipeliningEnabled() const throw()
+		{
+			return emulator.renderer.IsPipeliningEnabled();
+		}
+
+		Result Video::EnableDirtyLines(bool state) throw()
+		{
+			return emulator.renderer.EnableDirtyLines( state );
+		}
+
+		bool Video::AreDirtyLinesEnabled() const throw()
+		{
+			return emulator.renderer.AreDirtyLinesEnabled();
+		}
+
 		Result Video::SetRenderState(const RenderState& state) throw()
 		{
 			const Result result = emulator.renderer.SetState( state );
@@ -189,6 +219,21 @@ namespace Nes
 			return RESULT_ERR_NOT_READY;
 		}
 
+		const word* Video::GetPixelIndices() const throw()
+		{
+			return emulator.ppu.GetScreen().pixels;
+		}
+
+		Result Video::GetGrayscale(uchar* const pixels,const long pitch,const uint width,const uint height) const throw()
+		{
+			if (!pixels || !width || width > Core::Video::Screen::WIDTH || !height || height > Core::Video::Screen::HEIGHT)
+				return RESULT_ERR_INVALID_PARAM;
+
+			emulator.renderer.Reduce( emulator.ppu.GetScreen(), pixels, pitch, width, height );
+
+			return RESULT_OK;
+		}
+
 		Video::RenderState::RenderState() throw()
 		:
 		width  (0),
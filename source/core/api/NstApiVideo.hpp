@@ -76,7 +76,7 @@ namespace Nes
 				long pitch;
 
 				Output(void* v=0,long p=0)
-				: pixels(v), pitch(p) {}
+				: pixels(v), pitch(p), lockFunction(0), unlockFunction(0), userData(0) {}
 
 				/**
 				* Surface lock callback prototype.
@@ -99,6 +99,26 @@ namespace Nes
 				*/
 				typedef void (NST_CALLBACK *UnlockCallback) (void* userData,Output& output);
 
+				/**
+				* Per-output lock callback.
+				*
+				* Called instead of the static lockCallback if set. Lets emulator
+				* instances running side by side each keep their own callback.
+				*/
+				LockCallback lockFunction;
+
+				/**
+				* Per-output unlock callback.
+				*
+				* Called instead of the static unlockCallback if set.
+				*/
+				UnlockCallback unlockFunction;
+
+				/**
+				* Optional user data passed to the per-output callbacks.
+				*/
+				void* userData;
+
 				/**
 				* Surface lock callback manager.
 				*
@@ -123,7 +143,7 @@ namespace Nes
 			{
 				bool operator () (Output& output) const
 				{
-					return (!function || function( userdata, output )) && output.pixels && output.pitch;
+					return (output.lockFunction ? output.lockFunction( output.userData, output ) : (!function || function( userdata, output ))) && output.pixels && output.pitch;
 				}
 			};
 
@@ -136,7 +156,9 @@ namespace Nes
 			{
 				void operator () (Output& output) const
 				{
-					if (function)
+					if (output.unlockFunction)
+						output.unlockFunction( output.userData, output );
+					else if (function)
 						function( userdata, output );
 				}
 			};
@@ -204,7 +226,8 @@ namespace Nes
 				MAX_COLOR_FRINGING              = +100,
 				MIN_HUE                         =  -45,
 				DEFAULT_HUE                     =    0,
-				MAX_HUE                         =  +45
+				MAX_HUE                         =  +45,
+				MAX_FILTER_THREADS              =   15
 			};
 
 			/**
@@ -371,6 +394,68 @@ namespace Nes
 			*/
 			bool IsFieldMergingEnabled() const throw();
 
+			/**
+			* Sets the number of worker threads used for filtering.
+			*
+			* The picture is split into horizontal bands which are filtered in parallel
+			* by the worker threads and the calling thread. Blitting remains synchronous.
+			*
+			* @param count number of worker threads up to MAX_FILTER_THREADS, 0 (default) to filter on the calling thread only
+			* @return result code
+			*/
+			Result SetFilterThreads(uint count) throw();
+
+			/**
+			* Returns the number of worker threads used for filtering.
+			*
+			* @return number of worker threads
+			*/
+			uint GetFilterThreads() const throw();
+
+			/**
+			* Enables or disables pipelined blitting.
+			*
+			* When enabled, Emulator::Execute() no longer filters the picture before returning.
+			* The finished frame is copied to a second screen buffer and handed to a background
+			* thread, which filters it and calls the lock/unlock callbacks while the next frame
+			* is being emulated. Emulation itself is unaffected, but the picture presented lags
+			* one frame behind and the callbacks are invoked from the background thread. The surface
+			* memory must stay valid until the next call to Emulator::Execute() or Blit().
+			*
+			* @param state true to enable, false (default) to disable
+			* @return result code
+			*/
+			Result EnablePipelining(bool state) throw();
+
+			/**
+			* Checks if pipelined blitting is enabled.
+			*
+			* @return true if enabled
+			*/
+			bool IsPipeliningEnabled() const throw();
+
+			/**
+			* Enables or disables dirty line tracking.
+			*
+			* When enabled, each frame is compared line by line against the last one drawn and
+			* only the lines that changed, plus the neighboring lines the filter reads from, are
+			* filtered and written. All other lines of the surface are left untouched, so this
+			* is only valid if the surface handed to the lock callback keeps its contents between
+			* frames. A change of surface address, pitch, render state or palette redraws the
+			* whole picture.
+			*
+			* @param state true to enable, false (default) to disable
+			* @return result code
+			*/
+			Result EnableDirtyLines(bool state) throw();
+
+			/**
+			* Checks if dirty line tracking is enabled.
+			*
+			* @return true if enabled
+			*/
+			bool AreDirtyLinesEnabled() const throw();
+
 			/**
 			* Performs a manual blit to the video output object.
 			*
@@ -381,6 +466,34 @@ namespace Nes
 			*/
 			Result Blit(Output& output) throw();
 
+			/**
+			* Returns the picture of the last emulated frame as palette indices.
+			*
+			* The buffer holds 256x240 values row by row, as output by the PPU before any
+			* palette lookup or filtering. Each value indexes the 512 entries returned by
+			* Palette::GetColors(), with the color in bits 0-5 and the emphasis in bits 6-8.
+			* No render state is needed and no callback is invoked. The buffer belongs to
+			* the emulator and is overwritten by the next frame.
+			*
+			* @return pixel indices
+			*/
+			const word* GetPixelIndices() const throw();
+
+			/**
+			* Reduces the picture of the last emulated frame to 8-bit grayscale.
+			*
+			* The picture is converted to luminance through the current palette and scaled
+			* down by averaging the source pixels covered by each destination pixel, e.g. to
+			* 84x84. No render state is needed and no callback is invoked.
+			*
+			* @param pixels destination
+			* @param pitch distance in bytes from one destination row to the next
+			* @param width destination width, 1 to 256
+			* @param height destination height, 1 to 240
+			* @return result code
+			*/
+			Result GetGrayscale(uchar* pixels,long pitch,uint width,uint height) const throw();
+
 			/**
 			* YUV decoder presets.
 			*/
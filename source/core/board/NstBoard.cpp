@@ -389,6 +389,14 @@ namespace Nes
 				cpu.Map( 0xC000, 0xDFFF ).Set( this, &Board::Peek_Prg_C, &Board::Poke_Nop );
 				cpu.Map( 0xE000, 0xFFFF ).Set( this, &Board::Peek_Prg_E, &Board::Poke_Nop );
 
+				cpu.MapMemory( 0x8000, 0x9FFF, prg.Slot(0), SIZE_8K-1, this, &Board::Peek_Prg_8, &Board::Poke_Nop );
+				cpu.MapMemory( 0xA000, 0xBFFF, prg.Slot(1), SIZE_8K-1, this, &Board::Peek_Prg_A, &Board::Poke_Nop );
+				cpu.MapMemory( 0xC000, 0xDFFF, prg.Slot(2), SIZE_8K-1, this, &Board::Peek_Prg_C, &Board::Poke_Nop );
+				cpu.MapMemory( 0xE000, 0xFFFF, prg.Slot(3), SIZE_8K-1, this, &Board::Peek_Prg_E, &Board::Poke_Nop );
+
+				if (!prg.Source(0).Writable())
+					cpu.MapCode( prg.Source(0).Mem(), prg.Source(0).Size() );
+
 				if (hard)
 				{
 					wrk.Source().SetSecurity( true, board.GetWram() > 0 );
@@ -212,6 +212,11 @@ namespace Nes
 					return (count-- & 0xFFFF) == 0;
 				}
 
+				uint Lz93d50::Irq::Pending() const
+				{
+					return (count & 0xFFFF) + 1;
+				}
+
 				void Lz93d50::Sync(Event event,Input::Controllers* controllers)
 				{
 					if (event == EVENT_END_FRAME)
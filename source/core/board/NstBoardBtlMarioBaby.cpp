@@ -143,6 +143,11 @@ namespace Nes
 					return false;
 				}
 
+				uint MarioBaby::Irq::Pending() const
+				{
+					return 0x2000 - (count & 0x1FFF);
+				}
+
 				void MarioBaby::Sync(Event event,Input::Controllers* controllers)
 				{
 					if (event == EVENT_END_FRAME)
@@ -59,6 +59,7 @@ namespace Nes
 					{
 						void Reset(bool);
 						bool Clock();
+						uint Pending() const;
 
 						uint count;
 						Cpu& cpu;
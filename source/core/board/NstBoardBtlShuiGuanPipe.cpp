@@ -113,6 +113,14 @@ namespace Nes
 					return enabled && (++count[1] & 0xFF) == 0;
 				}
 
+				uint ShuiGuanPipe::Irq::Pending() const
+				{
+					if (!enabled)
+						return 0;
+
+					return (count[0] < 114 ? 114 - count[0] : 1) + (0xFF - (count[1] & 0xFF)) * 114;
+				}
+
 				NES_PEEK_A(ShuiGuanPipe,6000)
 				{
 					return wrk[0][address - 0x6000];
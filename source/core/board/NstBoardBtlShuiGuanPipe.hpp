@@ -62,6 +62,7 @@ namespace Nes
 					{
 						void Reset(bool);
 						bool Clock();
+						uint Pending() const;
 
 						ibool enabled;
 						uint count[2];
@@ -119,6 +119,11 @@ namespace Nes
 					return false;
 				}
 
+				uint Smb2a::Irq::Pending() const
+				{
+					return enabled ? 0x1000 - count : 0;
+				}
+
 				NES_PEEK_A(Smb2a,6000)
 				{
 					return wrk[0][address - 0x6000];
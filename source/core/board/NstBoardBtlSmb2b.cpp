@@ -127,6 +127,11 @@ namespace Nes
 					return ++count == 0x1000;
 				}
 
+				uint Smb2b::Irq::Pending() const
+				{
+					return count < 0x1000 ? 0x1000 - count : 0;
+				}
+
 				void Smb2b::Sync(Event event,Input::Controllers* controllers)
 				{
 					if (event == EVENT_END_FRAME)
@@ -58,6 +58,7 @@ namespace Nes
 					{
 						void Reset(bool);
 						bool Clock();
+						uint Pending() const;
 
 						uint count;
 					};
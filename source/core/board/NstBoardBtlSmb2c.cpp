@@ -122,6 +122,11 @@ namespace Nes
 
 				}
 
+				uint Smb2c::Irq::Pending() const
+				{
+					return enabled ? 0x1000 - count : 0;
+				}
+
 				NES_POKE_D(Smb2c,4022)
 				{
 					prg.SwapBank<SIZE_32K,0x0000>( data & 0x1 );
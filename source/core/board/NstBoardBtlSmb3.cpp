@@ -164,6 +164,11 @@ namespace Nes
 					return enabled && (count = (count + 1) & 0xFFFF) == 0x0000 ? (enabled=false, true) : false;
 				}
 
+				uint Smb3::Irq::Pending() const
+				{
+					return enabled ? 0x10000 - count : 0;
+				}
+
 				void Smb3::Sync(Event event,Input::Controllers* controllers)
 				{
 					if (event == EVENT_END_FRAME)
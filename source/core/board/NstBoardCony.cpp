@@ -404,6 +404,14 @@ namespace Nes
 					return false;
 				}
 
+				uint Standard::Irq::Pending() const
+				{
+					if (!enabled || !count)
+						return 0;
+
+					return step == 1 ? 0x10000 - count : count;
+				}
+
 				void Standard::Sync(Event event,Input::Controllers* controllers)
 				{
 					if (event == EVENT_END_FRAME)
@@ -72,6 +72,7 @@ namespace Nes
 					{
 						void Reset(bool);
 						bool Clock();
+						uint Pending() const;
 
 						ibool enabled;
 						uint count;
@@ -250,6 +250,11 @@ namespace Nes
 				return count && --count == 0;
 			}
 
+			uint Event::Irq::Pending() const
+			{
+				return count;
+			}
+
 			void Event::Sync(Board::Event event,Input::Controllers* controllers)
 			{
 				if (event == EVENT_END_FRAME)
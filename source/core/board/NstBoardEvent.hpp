@@ -84,6 +84,7 @@ namespace Nes
 				{
 					void Reset(bool);
 					bool Clock();
+					uint Pending() const;
 
 					dword count;
 				};
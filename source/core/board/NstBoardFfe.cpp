@@ -203,6 +203,11 @@ namespace Nes
 				return false;
 			}
 
+			uint Ffe::Irq::Pending() const
+			{
+				return enabled && count <= clock ? clock - count + 1 : 0;
+			}
+
 			NES_POKE_D(Ffe,42FE)
 			{
 				mode = data >> 7 ^ 0x1;
@@ -74,6 +74,7 @@ namespace Nes
 				{
 					void Reset(bool);
 					bool Clock();
+					uint Pending() const;
 
 					uint count;
 					ibool enabled;
@@ -156,6 +156,11 @@ namespace Nes
 					return false;
 				}
 
+				uint H3001::Irq::Pending() const
+				{
+					return enabled ? count : 0;
+				}
+
 				void H3001::Sync(Event event,Input::Controllers* controllers)
 				{
 					if (event == EVENT_END_FRAME)
@@ -296,6 +296,11 @@ namespace Nes
 					return (count & mask) && !(--count & mask);
 				}
 
+				uint Ss88006::Irq::Pending() const
+				{
+					return count & mask;
+				}
+
 				void Ss88006::Sync(Event event,Input::Controllers* controllers)
 				{
 					if (event == EVENT_END_FRAME)
@@ -95,6 +95,7 @@ namespace Nes
 					{
 						void Reset(bool);
 						bool Clock();
+						uint Pending() const;
 
 						uint mask;
 						uint count;
@@ -447,6 +447,17 @@ namespace Nes
 					return base.IsEnabled(MODE_M2) && base.Clock();
 				}
 
+				uint Standard::Irq::M2::Pending() const
+				{
+					if (!base.IsEnabled(MODE_M2))
+						return 0;
+
+					if (base.mode & MODE_COUNT_DOWN)
+						return (base.prescaler & base.scale) + 1 + (base.count & 0xFF) * (base.scale + 1);
+					else
+						return (base.scale - (base.prescaler & base.scale)) + 1 + (0xFF - (base.count & 0xFF)) * (base.scale + 1);
+				}
+
 				uint Standard::Banks::Unscramble(const uint bank)
 				{
 					return
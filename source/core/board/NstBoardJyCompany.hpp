@@ -194,6 +194,7 @@ namespace Nes
 
 							void Reset(bool);
 							bool Clock();
+							uint Pending() const;
 
 							Irq& base;
 						};
@@ -289,6 +289,11 @@ namespace Nes
 					return (count++ == 0xFFFF) ? (count=latch, true) : false;
 				}
 
+				uint Ks202::Irq::Pending() const
+				{
+					return 0x10000 - (count & 0xFFFF);
+				}
+
 				void Ks202::Sync(Event event,Input::Controllers* controllers)
 				{
 					if (event == EVENT_END_FRAME)
@@ -78,6 +78,7 @@ namespace Nes
 					{
 						void Reset(bool);
 						bool Clock();
+						uint Pending() const;
 
 						uint count;
 						uint latch;
@@ -115,6 +115,11 @@ namespace Nes
 					return false;
 				}
 
+				uint Vrc3::Irq::Pending() const
+				{
+					return enabled ? 0x10000 - count : 0;
+				}
+
 				NES_POKE_D(Vrc3,8000)
 				{
 					irq.Update();
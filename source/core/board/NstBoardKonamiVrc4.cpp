@@ -306,6 +306,18 @@ namespace Nes
 					return true;
 				}
 
+				uint Vrc4::BaseIrq::Pending() const
+				{
+					// the prescaler takes 113 or 114 clocks per step
+
+					const uint steps = 0xFF - count[1];
+
+					if (ctrl & NO_PPU_SYNC)
+						return steps + 1;
+
+					return (count[0] < 341-3 ? (341-3 - count[0] + 2) / 3 + 1 : 1) + steps * 113;
+				}
+
 				void Vrc4::Sync(Event event,Input::Controllers* controllers)
 				{
 					if (event == EVENT_END_FRAME)
@@ -315,6 +315,9 @@ namespace Nes
 					nextSample = 0;
 					ampPhase = 0;
 					pitchPhase = 0;
+					block.pos = 0;
+					block.length = 0;
+					block.prepared = 0;
 				}
 
 				void Vrc7::Sound::Refresh()
@@ -783,6 +786,9 @@ namespace Nes
 				{
 					Update();
 
+					NST_VERIFY( block.pos == block.length );
+					block.prepared = 0;
+
 					switch (regSelect & 0x3F)
 					{
 						case 0x00:
@@ -983,6 +989,54 @@ namespace Nes
 					return (output + slots[CARRIER].output) / 2;
 				}
 
+				NST_SINGLE_CALL void Vrc7::Sound::OpllChannel::Render(Sample* const NST_RESTRICT samples,const uint (*const lfo)[2],const uint length,const Tables& tables)
+				{
+					for (uint i=0; i < length; ++i)
+						samples[i] += GetSample( lfo[i][0], lfo[i][1], tables );
+				}
+
+				void Vrc7::Sound::Render(const uint length)
+				{
+					NST_ASSERT( length && length <= BLOCK_SIZE );
+
+					for (uint i=0; i < length; ++i)
+					{
+						pitchPhase = (pitchPhase + PITCH_RATE) & PITCH_RANGE;
+						ampPhase = (ampPhase + AMP_RATE) & AMP_RANGE;
+
+						block.lfo[i][0] = tables.GetPitch( pitchPhase >> PITCH_SHIFT );
+						block.lfo[i][1] = tables.GetAmp( ampPhase >> AMP_SHIFT );
+						block.samples[i] = 0;
+					}
+
+					for (uint i=0; i < NUM_OPLL_CHANNELS; ++i)
+						channels[i].Render( block.samples, block.lfo, length, tables );
+
+					block.pos = 0;
+					block.length = length;
+					block.prepared = (block.prepared > length ? block.prepared - length : 0);
+				}
+
+				void Vrc7::Sound::Prepare(const uint length)
+				{
+					if (output)
+					{
+						dword phase = samplePhase;
+						dword ticks = 0;
+
+						for (uint i=0; i < length; ++i)
+						{
+							for (; phase < sampleRate; phase += CLOCK_RATE)
+								++ticks;
+
+							phase -= sampleRate;
+						}
+
+						const uint pending = block.length - block.pos;
+						block.prepared = (ticks > pending ? ticks - pending : 0);
+					}
+				}
+
 				Vrc7::Sound::Sample Vrc7::Sound::GetSample()
 				{
 					if (output)
@@ -991,20 +1045,11 @@ namespace Nes
 						{
 							samplePhase += CLOCK_RATE;
 
-							pitchPhase = (pitchPhase + PITCH_RATE) & PITCH_RANGE;
-							ampPhase = (ampPhase + AMP_RATE) & AMP_RANGE;
-
-							const uint lfo[2] =
-							{
-								tables.GetPitch( pitchPhase >> PITCH_SHIFT ),
-								tables.GetAmp( ampPhase >> AMP_SHIFT )
-							};
+							if (block.pos == block.length)
+								Render( block.prepared ? NST_MIN(block.prepared,dword(BLOCK_SIZE)) : 1 );
 
 							prevSample = nextSample;
-							nextSample = 0;
-
-							for (uint i=0; i < NUM_OPLL_CHANNELS; ++i)
-								nextSample += channels[i].GetSample( lfo[0], lfo[1], tables );
+							nextSample = block.samples[block.pos++];
 						}
 
 						samplePhase -= sampleRate;
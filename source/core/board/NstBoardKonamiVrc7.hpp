@@ -59,11 +59,13 @@ namespace Nes
 						void Reset();
 						bool UpdateSettings();
 						Sample GetSample();
+						void Prepare(uint);
 
 					private:
 
 						void ResetClock();
 						void Refresh();
+						void Render(uint);
 
 						enum
 						{
@@ -83,6 +85,7 @@ namespace Nes
 							DB2LIN_SIZE    = 0x400,
 							TL_SIZE        = 0x40,
 							FEEDBACK_SHIFT = 8,
+							BLOCK_SIZE     = 0x100,
 							CLOCK_DIV      = 3579545 / 72,
 							CLOCK_RATE     = (1UL << 31) / CLOCK_DIV,
 							PG_PHASE_RANGE = (1UL << 18) - 1,
@@ -149,6 +152,7 @@ namespace Nes
 							NST_SINGLE_CALL void WriteRegA (uint,const Tables&);
 
 							NST_SINGLE_CALL Sample GetSample(uint,uint,const Tables&);
+							NST_SINGLE_CALL void Render(Sample*,const uint (*)[2],uint,const Tables&);
 
 						private:
 
@@ -252,6 +256,15 @@ namespace Nes
 						Sample prevSample;
 						Sample nextSample;
 
+						struct
+						{
+							uint pos;
+							uint length;
+							dword prepared;
+							uint lfo[BLOCK_SIZE][2];
+							Sample samples[BLOCK_SIZE];
+						}   block;
+
 						OpllChannel channels[NUM_OPLL_CHANNELS];
 						const Tables tables;
 
@@ -272,6 +272,11 @@ namespace Nes
 					return (count - 0x8000 < 0x7FFF) && (++count == 0xFFFF);
 				}
 
+				uint N163::Irq::Pending() const
+				{
+					return (count - 0x8000 < 0x7FFF) ? 0xFFFF - count : 0;
+				}
+
 				inline bool N163::Sound::BaseChannel::CanOutput() const
 				{
 					return volume && frequency && enabled;
@@ -136,6 +136,11 @@ namespace Nes
 					return false;
 				}
 
+				uint S3::Irq::Pending() const
+				{
+					return enabled ? count : 0;
+				}
+
 				void S3::Sync(Event event,Input::Controllers* controllers)
 				{
 					if (event == EVENT_END_FRAME)
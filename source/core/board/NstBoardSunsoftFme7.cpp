@@ -196,6 +196,11 @@ namespace Nes
 					return count < enabled;
 				}
 
+				uint Fme7::Irq::Pending() const
+				{
+					return enabled ? (count ? count : 0x10000) : 0;
+				}
+
 				void Fme7::Sync(Event event,Input::Controllers* controllers)
 				{
 					if (event == EVENT_END_FRAME)
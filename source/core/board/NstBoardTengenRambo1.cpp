@@ -205,6 +205,17 @@ namespace Nes
 					}
 				}
 
+				uint Rambo1::Irq::Unit::Pending() const
+				{
+					if (!enabled)
+						return 0;
+
+					if (reload)
+						return latch + 2;
+
+					return count ? count : latch ? latch + 1 : 0;
+				}
+
 				void Rambo1::Irq::Update()
 				{
 					a12.Update();
@@ -32,14 +32,14 @@ namespace Nes
 	{
 		namespace Input
 		{
-			uint Pad::mic;
-
 			#ifdef NST_MSVC_OPTIMIZE
 			#pragma optimize("s", on)
 			#endif
 
-			Pad::Pad(const Cpu& c,uint i)
-			: Device(c,Type(uint(Api::Input::PAD1) + i))
+			Pad::Pad(const Cpu& c,uint i,uint& m)
+			:
+			Device (c,Type(uint(Api::Input::PAD1) + i)),
+			mic    (m)
 			{
 				NST_ASSERT( i < 4 );
 
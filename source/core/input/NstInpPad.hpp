@@ -39,7 +39,7 @@ namespace Nes
 			{
 			public:
 
-				Pad(const Cpu&,uint);
+				Pad(const Cpu&,uint,uint&);
 
 			private:
 
@@ -55,8 +55,7 @@ namespace Nes
 				uint stream;
 				uint state;
 				uint timeStamp;
-
-				static uint mic;
+				uint& mic;
 			};
 		}
 	}